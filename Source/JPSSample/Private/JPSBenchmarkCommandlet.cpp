@@ -0,0 +1,610 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "JPSBenchmarkCommandlet.h"
+
+#include "JPSGrid.h"
+#include "JPSPathfinder.h"
+#include "JPSMovingAI.h"
+#include "JPSCorpus.h"
+#include "JPSNeighbourMasks.h"
+#include "JPSGridAStar.h"
+#include "GraphAStar.h"
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogJPSBenchmark, Log, All);
+
+namespace JPSBenchmark
+{
+	// FGraphAStar가 비트배열 맵을 바로 읽는 그래프, AAStarCollision과 같은 8방향 이동 규칙
+	struct FGridGraph
+	{
+		typedef FIntPoint FNodeRef;
+
+		FJPSGridView Grid;
+		// 있으면 이동 가능한 이웃만 나열한다
+		const FJPSNeighbourMasks* Masks = nullptr;
+
+		int32 GetNeighbourCount(FNodeRef InNodeRef) const { return Masks ? FMath::CountBits(Masks->Get(InNodeRef.X, InNodeRef.Y)) : 8; }
+		bool IsValidRef(FNodeRef InNodeRef) const { return !Grid.IsCollision(InNodeRef.X, InNodeRef.Y); }
+		FNodeRef GetNeighbour(const FGraphAStarDefaultNode<FGridGraph>& InNode, const int32 InNeighbourIndex) const
+		{
+			if (Masks)
+			{
+				const uint8 Mask = Masks->Get(InNode.NodeRef.X, InNode.NodeRef.Y);
+				return InNode.NodeRef + FJPSNeighbourMasks::GetOffset(FJPSNeighbourMasks::GetNthDirection(Mask, InNeighbourIndex));
+			}
+			static const FIntPoint Directions[] = { FIntPoint(1, 0), FIntPoint(1, -1), FIntPoint(0, -1), FIntPoint(-1, -1), FIntPoint(-1, 0), FIntPoint(-1, 1), FIntPoint(0, 1), FIntPoint(1, 1) };
+			return InNode.NodeRef + Directions[InNeighbourIndex];
+		}
+	};
+	typedef FGraphAStarDefaultNode<FGridGraph> FGridNode;
+
+	// FGridQueryFilter와 같은 옥타일 비용
+	struct FGridFilter
+	{
+		FVector::FReal GetHeuristicScale() const { return 1.0f; }
+		FVector::FReal GetHeuristicCost(const FGridNode& InStartNode, const FGridNode& InEndNode) const
+		{
+			const int32 Dx = FMath::Abs(InStartNode.NodeRef.X - InEndNode.NodeRef.X);
+			const int32 Dy = FMath::Abs(InStartNode.NodeRef.Y - InEndNode.NodeRef.Y);
+			return FMath::Max(Dx, Dy) + (1.41421356237f - 1) * FMath::Min(Dx, Dy);
+		}
+		FVector::FReal GetTraversalCost(const FGridNode& InStartNode, const FGridNode& InEndNode) const
+		{
+			const FIntPoint Delta = InEndNode.NodeRef - InStartNode.NodeRef;
+			return (FMath::Abs(Delta.X) + FMath::Abs(Delta.Y) > 1) ? 1.41421356237f : 1.0f;
+		}
+		bool IsTraversalAllowed(FIntPoint InNodeA, FIntPoint InNodeB) const { return true; }
+		bool WantsPartialSolution() const { return false; }
+	};
+
+	enum class EEngine : uint8
+	{
+		JPS,
+		JPSPlus,
+		JPSGoalBounds,
+		GraphAStar,
+		GraphAStarMasks,
+		GridAStar,
+	};
+	static const TCHAR* EngineNames[] = { TEXT("JPS"), TEXT("JPSPlus"), TEXT("JPSGoalBounds"), TEXT("GraphAStar"), TEXT("GraphAStarMasks"), TEXT("GridAStar") };
+
+	// 탐색 한 번의 측정값
+	struct FQuerySample
+	{
+		double Seconds = 0.0;
+		int32 Expansions = 0;
+		double Cost = 0.0;
+		bool bFound = false;
+	};
+
+	// 맵 하나, 엔진 하나, 스레드 수 하나의 집계
+	struct FRunResult
+	{
+		FString Map;
+		int32 Width = 0;
+		int32 Height = 0;
+		float Density = 0.0f;
+		FString Engine;
+		int32 Threads = 0;
+		int32 Queries = 0;
+		int32 Found = 0;
+		// 마이크로초
+		double P50 = 0.0;
+		double P95 = 0.0;
+		double P99 = 0.0;
+		double Max = 0.0;
+		double Mean = 0.0;
+		double MeanExpansions = 0.0;
+		double MeanCost = 0.0;
+		// 스레드 하나가 탐색 사이에 유지하는 버퍼 중 가장 큰 값
+		int64 BytesPerThread = 0;
+		// 점프 거리 테이블이나 경계 상자처럼 탐색 전에 만드는 데이터
+		int64 PrecomputeBytes = 0;
+		double PrecomputeSeconds = 0.0;
+		double QueriesPerSecond = 0.0;
+		// 경로가 시나리오의 최적 길이보다 긴 탐색 수, 시나리오가 없으면 -1
+		int32 Longer = -1;
+	};
+
+	// 맵마다 같은 조건으로 돌리는 설정
+	struct FOptions
+	{
+		TArray<FString> Engines;
+		TArray<int32> ThreadCounts;
+		int32 MaxThreads = 1;
+	};
+
+	template <typename Ty>
+	static TArray<Ty> ParseList(const FString& InParams, const TCHAR* InKey, TArray<Ty> InDefault)
+	{
+		FString Value;
+		if (!FParse::Value(*InParams, InKey, Value, false))
+		{
+			return InDefault;
+		}
+
+		TArray<FString> Tokens;
+		Value.ParseIntoArray(Tokens, TEXT(","));
+		TArray<Ty> Result;
+		for (const FString& Token : Tokens)
+		{
+			Ty Parsed;
+			LexFromString(Parsed, *Token);
+			Result.Add(Parsed);
+		}
+		return Result.Num() ? Result : InDefault;
+	}
+
+	// 시드로 결정되는 무작위 장애물 맵
+	static FJPSMovingAIMap GenerateRandomMap(int32 InSize, float InDensity, int32 InSeed)
+	{
+		FJPSMovingAIMap Map;
+		Map.Width = InSize;
+		Map.Height = InSize;
+		Map.WordWidths = FMath::DivideAndRoundUp(InSize, 64);
+		Map.Bitmap.SetNumZeroed(Map.WordWidths * InSize);
+
+		FRandomStream Random(InSeed);
+		for (int32 Y = 0; Y < InSize; Y++)
+		{
+			for (int32 X = 0; X < InSize; X++)
+			{
+				if (Random.FRand() < InDensity)
+				{
+					Map.Bitmap[Y * Map.WordWidths + X / 64] |= 1ULL << (X % 64);
+				}
+			}
+		}
+		return Map;
+	}
+
+	// 연결된 칸끼리만 요청을 만든다, 실패하는 탐색이 섞이면 엔진마다 실패 비용이 달라서 비교가 흐려진다
+	static TArray<FPathRequest> MakeQueries(const FJPSGridView& InGrid, int32 InCount, int32 InSeed)
+	{
+		const int32 Width = InGrid.GetWidth();
+		const int32 Height = InGrid.GetHeight();
+
+		// 8방향 연결 요소, 모서리를 끼고 도는 대각선 이동도 허용하기 때문에 대각선 이웃은 항상 연결된다
+		TArray<int32> Components;
+		Components.Init(INDEX_NONE, Width * Height);
+		TArray<int32> Sizes;
+		TArray<int32> Stack;
+		for (int32 Cell = 0; Cell < Width * Height; Cell++)
+		{
+			if (Components[Cell] != INDEX_NONE || InGrid.IsCollision(Cell % Width, Cell / Width))
+			{
+				continue;
+			}
+
+			const int32 Component = Sizes.Add(0);
+			Components[Cell] = Component;
+			Stack.Add(Cell);
+			while (Stack.Num())
+			{
+				const int32 Current = Stack.Pop();
+				Sizes[Component]++;
+				for (int32 Dy = -1; Dy <= 1; Dy++)
+				{
+					for (int32 Dx = -1; Dx <= 1; Dx++)
+					{
+						const int32 X = Current % Width + Dx;
+						const int32 Y = Current / Width + Dy;
+						if (!InGrid.IsCollision(X, Y) && Components[Y * Width + X] == INDEX_NONE)
+						{
+							Components[Y * Width + X] = Component;
+							Stack.Add(Y * Width + X);
+						}
+					}
+				}
+			}
+		}
+
+		TArray<FPathRequest> Queries;
+		FRandomStream Random(InSeed);
+		int32 Attempts = 0;
+		while (Queries.Num() < InCount && Attempts++ < InCount * 100)
+		{
+			FPathRequest Request;
+			Request.Start = FIntPoint(Random.RandRange(0, Width - 1), Random.RandRange(0, Height - 1));
+			Request.End = FIntPoint(Random.RandRange(0, Width - 1), Random.RandRange(0, Height - 1));
+			const int32 StartComponent = Components[Request.Start.Y * Width + Request.Start.X];
+			const int32 EndComponent = Components[Request.End.Y * Width + Request.End.X];
+			if (StartComponent != INDEX_NONE && StartComponent == EndComponent && Request.Start != Request.End)
+			{
+				Queries.Add(Request);
+			}
+		}
+		return Queries;
+	}
+
+	static double Percentile(const TArray<double>& InSorted, double InRatio)
+	{
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(InRatio * InSorted.Num()) - 1, 0, InSorted.Num() - 1);
+		return InSorted[Index];
+	}
+
+	// 요청을 스레드 수만큼 나눠서 탐색하고 집계한다, 스레드마다 컨텍스트를 하나씩 두고 요청 사이에 재사용한다
+	// InScenarios가 있으면 요청과 같은 순서이고 경로 길이를 최적값과 비교한다
+	static FRunResult Run(EEngine InEngine, const FJPSPathfinder& InPathfinder, const FGridGraph& InGraph, const FJPSGridAStar& InGridAStar, const TArray<FPathRequest>& InQueries, const TArray<FJPSMovingAIScenario>* InScenarios, int32 InThreads)
+	{
+		TArray<FQuerySample> Samples;
+		Samples.SetNum(InQueries.Num());
+		TArray<int64> WorkerBytes;
+		WorkerBytes.SetNumZeroed(InThreads);
+
+		const uint64 StartCycles = FPlatformTime::Cycles64();
+		ParallelFor(InThreads, [&](int32 InWorker)
+		{
+			TArray<FIntPoint> Path;
+			if (InEngine == EEngine::GraphAStar || InEngine == EEngine::GraphAStarMasks)
+			{
+				FGraphAStar<FGridGraph> AStar(InGraph);
+				const FGridFilter Filter;
+				for (int32 Index = InWorker; Index < InQueries.Num(); Index += InThreads)
+				{
+					const FPathRequest& Query = InQueries[Index];
+					FQuerySample& Sample = Samples[Index];
+					Path.Reset();
+
+					const uint64 QueryCycles = FPlatformTime::Cycles64();
+					Sample.bFound = AStar.FindPath(FGridNode(Query.Start), FGridNode(Query.End), Filter, Path) == EGraphAStarResult::SearchSuccess;
+					Sample.Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - QueryCycles);
+
+					for (const FGridNode& Node : AStar.NodePool)
+					{
+						Sample.Expansions += Node.bIsClosed ? 1 : 0;
+					}
+					Sample.Cost = Sample.bFound ? FJPSMovingAI::GetPathLength(Query.Start, Path) : 0.0;
+					WorkerBytes[InWorker] = FMath::Max<int64>(WorkerBytes[InWorker], AStar.NodePool.GetAllocatedSize() + AStar.OpenList.GetAllocatedSize());
+				}
+			}
+			else if (InEngine == EEngine::GridAStar)
+			{
+				FJPSGridAStarContext Context;
+				for (int32 Index = InWorker; Index < InQueries.Num(); Index += InThreads)
+				{
+					const FPathRequest& Query = InQueries[Index];
+					FQuerySample& Sample = Samples[Index];
+
+					const uint64 QueryCycles = FPlatformTime::Cycles64();
+					Sample.bFound = InGridAStar.Search(Context, Query.Start, Query.End, Path);
+					Sample.Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - QueryCycles);
+
+					Sample.Expansions = Context.Stats.Expansions;
+					Sample.Cost = Sample.bFound ? FJPSMovingAI::GetPathLength(Query.Start, Path) : 0.0;
+				}
+				WorkerBytes[InWorker] = Context.GetAllocatedSize();
+			}
+			else
+			{
+				FJPSSearchContext Context;
+				for (int32 Index = InWorker; Index < InQueries.Num(); Index += InThreads)
+				{
+					const FPathRequest& Query = InQueries[Index];
+					FQuerySample& Sample = Samples[Index];
+
+					const uint64 QueryCycles = FPlatformTime::Cycles64();
+					Sample.bFound = InPathfinder.Search(Context, Query.Start, Query.End, Path);
+					Sample.Seconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - QueryCycles);
+
+					Sample.Expansions = Context.Stats.Expansions;
+					Sample.Cost = Sample.bFound ? FJPSMovingAI::GetPathLength(Query.Start, Path) : 0.0;
+				}
+				WorkerBytes[InWorker] = Context.GetAllocatedSize();
+			}
+		}, InThreads == 1 ? EParallelForFlags::ForceSingleThread : EParallelForFlags::None);
+		const double WallSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+
+		FRunResult Result;
+		Result.Engine = EngineNames[static_cast<int32>(InEngine)];
+		Result.Threads = InThreads;
+		Result.Queries = InQueries.Num();
+		Result.QueriesPerSecond = InQueries.Num() / FMath::Max(WallSeconds, 1e-9);
+		for (int64 Bytes : WorkerBytes)
+		{
+			Result.BytesPerThread = FMath::Max(Result.BytesPerThread, Bytes);
+		}
+
+		TArray<double> Latencies;
+		Latencies.Reserve(Samples.Num());
+		Result.Longer = InScenarios ? 0 : -1;
+		for (int32 Index = 0; Index < Samples.Num(); Index++)
+		{
+			const FQuerySample& Sample = Samples[Index];
+			if (InScenarios && FJPSMovingAI::CheckPath((*InScenarios)[Index], Sample.bFound, Sample.Cost) == EJPSScenarioCheck::Longer)
+			{
+				Result.Longer++;
+			}
+			Latencies.Add(Sample.Seconds * 1e6);
+			Result.Mean += Sample.Seconds * 1e6;
+			Result.MeanExpansions += Sample.Expansions;
+			Result.MeanCost += Sample.Cost;
+			Result.Found += Sample.bFound ? 1 : 0;
+		}
+
+		if (Latencies.Num())
+		{
+			Latencies.Sort();
+			Result.P50 = Percentile(Latencies, 0.50);
+			Result.P95 = Percentile(Latencies, 0.95);
+			Result.P99 = Percentile(Latencies, 0.99);
+			Result.Max = Latencies.Last();
+			Result.Mean /= Latencies.Num();
+			Result.MeanExpansions /= Latencies.Num();
+			Result.MeanCost /= FMath::Max(Result.Found, 1);
+		}
+		return Result;
+	}
+
+	static TSharedRef<FJsonObject> ToJson(const FRunResult& InResult)
+	{
+		TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("map"), InResult.Map);
+		Object->SetNumberField(TEXT("width"), InResult.Width);
+		Object->SetNumberField(TEXT("height"), InResult.Height);
+		Object->SetNumberField(TEXT("density"), InResult.Density);
+		Object->SetStringField(TEXT("engine"), InResult.Engine);
+		Object->SetNumberField(TEXT("threads"), InResult.Threads);
+		Object->SetNumberField(TEXT("queries"), InResult.Queries);
+		Object->SetNumberField(TEXT("found"), InResult.Found);
+		Object->SetNumberField(TEXT("p50_us"), InResult.P50);
+		Object->SetNumberField(TEXT("p95_us"), InResult.P95);
+		Object->SetNumberField(TEXT("p99_us"), InResult.P99);
+		Object->SetNumberField(TEXT("max_us"), InResult.Max);
+		Object->SetNumberField(TEXT("mean_us"), InResult.Mean);
+		Object->SetNumberField(TEXT("mean_expansions"), InResult.MeanExpansions);
+		Object->SetNumberField(TEXT("mean_cost"), InResult.MeanCost);
+		Object->SetNumberField(TEXT("bytes_per_thread"), InResult.BytesPerThread);
+		Object->SetNumberField(TEXT("precompute_bytes"), InResult.PrecomputeBytes);
+		Object->SetNumberField(TEXT("precompute_seconds"), InResult.PrecomputeSeconds);
+		Object->SetNumberField(TEXT("queries_per_second"), InResult.QueriesPerSecond);
+		Object->SetNumberField(TEXT("longer_than_optimal"), InResult.Longer);
+		return Object;
+	}
+
+	static const TCHAR* CsvHeader = TEXT("map,width,height,density,engine,threads,queries,found,p50_us,p95_us,p99_us,max_us,mean_us,mean_expansions,mean_cost,bytes_per_thread,precompute_bytes,precompute_seconds,queries_per_second,longer_than_optimal");
+
+	static FString ToCsv(const FRunResult& InResult)
+	{
+		return FString::Printf(TEXT("%s,%d,%d,%.3f,%s,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%.3f,%lld,%lld,%.4f,%.1f,%d"),
+			*InResult.Map, InResult.Width, InResult.Height, InResult.Density, *InResult.Engine, InResult.Threads, InResult.Queries, InResult.Found,
+			InResult.P50, InResult.P95, InResult.P99, InResult.Max, InResult.Mean, InResult.MeanExpansions, InResult.MeanCost,
+			InResult.BytesPerThread, InResult.PrecomputeBytes, InResult.PrecomputeSeconds, InResult.QueriesPerSecond, InResult.Longer);
+	}
+
+	// 맵 하나를 설정된 엔진과 스레드 수로 모두 측정한다
+	static void RunMap(const FString& InMapName, const FJPSGrid& InGrid, float InDensity, const TArray<FPathRequest>& InQueries, const TArray<FJPSMovingAIScenario>* InScenarios, const FOptions& InOptions, TArray<FRunResult>& OutResults)
+	{
+		const FJPSGridView View = InGrid.GetView();
+		FGridGraph Graph;
+		Graph.Grid = View;
+		FJPSGridAStar GridAStar;
+		GridAStar.SetMap(View);
+
+		for (int32 EngineIndex = 0; EngineIndex < static_cast<int32>(UE_ARRAY_COUNT(EngineNames)); EngineIndex++)
+		{
+			const EEngine Engine = static_cast<EEngine>(EngineIndex);
+			if (!InOptions.Engines.Contains(EngineNames[EngineIndex]))
+			{
+				continue;
+			}
+
+			// 엔진마다 전처리를 따로 하고 탐색 전에 끝낸다
+			FJPSPathfinder Pathfinder;
+			Pathfinder.SetMap(View);
+			FJPSNeighbourMasks NeighbourMasks;
+			FGridGraph EngineGraph = Graph;
+			int64 PrecomputeBytes = 0;
+			const double PrecomputeStart = FPlatformTime::Seconds();
+			if (Engine == EEngine::JPSPlus)
+			{
+				if (!Pathfinder.BuildJumpTable())
+				{
+					continue;
+				}
+				PrecomputeBytes = Pathfinder.GetJumpTable().GetAllocatedSize();
+			}
+			else if (Engine == EEngine::JPSGoalBounds)
+			{
+				if (View.GetWidth() * View.GetHeight() > FJPSGoalBounds::MAX_CELLS)
+				{
+					UE_LOG(LogJPSBenchmark, Warning, TEXT("Skip %s on %s: more than %d cells"), EngineNames[EngineIndex], *InMapName, FJPSGoalBounds::MAX_CELLS);
+					continue;
+				}
+				if (!Pathfinder.BuildGoalBounds())
+				{
+					continue;
+				}
+				PrecomputeBytes = Pathfinder.GetGoalBounds().GetAllocatedSize();
+			}
+			else if (Engine == EEngine::GraphAStarMasks)
+			{
+				if (!NeighbourMasks.Build(View))
+				{
+					continue;
+				}
+				EngineGraph.Masks = &NeighbourMasks;
+				PrecomputeBytes = NeighbourMasks.GetAllocatedSize();
+			}
+			const double PrecomputeSeconds = FPlatformTime::Seconds() - PrecomputeStart;
+
+			for (int32 Threads : InOptions.ThreadCounts)
+			{
+				FRunResult Result = Run(Engine, Pathfinder, EngineGraph, GridAStar, InQueries, InScenarios, FMath::Clamp(Threads, 1, InOptions.MaxThreads));
+				Result.Map = InMapName;
+				Result.Width = View.GetWidth();
+				Result.Height = View.GetHeight();
+				Result.Density = InDensity;
+				Result.PrecomputeBytes = PrecomputeBytes;
+				Result.PrecomputeSeconds = PrecomputeSeconds;
+
+				UE_LOG(LogJPSBenchmark, Display, TEXT("%s [%s] [Threads = %d] [Found : %d / %d] [p50 %.1f us] [p95 %.1f us] [p99 %.1f us] [max %.1f us] [Expansions : %.1f] [%.0f queries/s]"),
+					*InMapName, *Result.Engine, Result.Threads, Result.Found, Result.Queries, Result.P50, Result.P95, Result.P99, Result.Max, Result.MeanExpansions, Result.QueriesPerSecond);
+				if (Result.Longer > 0)
+				{
+					UE_LOG(LogJPSBenchmark, Error, TEXT("%s [%s] returned %d paths longer than the scenario optimum"), *InMapName, *Result.Engine, Result.Longer);
+				}
+				OutResults.Add(MoveTemp(Result));
+			}
+		}
+	}
+}
+
+UJPSBenchmarkCommandlet::UJPSBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32 UJPSBenchmarkCommandlet::Main(const FString& Params)
+{
+	using namespace JPSBenchmark;
+
+	// MovingAI 시나리오 파일(.scen) 목록, 맵 파일은 시나리오 파일 옆에서 찾는다
+	const TArray<FString> ScenarioPaths = ParseList<FString>(Params, TEXT("Scenarios="), {});
+	// 시나리오만 넘기면 -Sizes=를 함께 지정하지 않는 한 생성 맵은 건너뛴다
+	const TArray<int32> Sizes = ParseList<int32>(Params, TEXT("Sizes="), ScenarioPaths.Num() ? TArray<int32>() : TArray<int32>({ 256, 1024 }));
+	const TArray<float> Densities = ParseList<float>(Params, TEXT("Densities="), { 0.2f, 0.35f });
+
+	FOptions Options;
+	Options.MaxThreads = FTaskGraphInterface::Get().GetNumWorkerThreads() + 1;
+	Options.ThreadCounts = ParseList<int32>(Params, TEXT("Threads="), { 1, Options.MaxThreads });
+	// 목적지 경계 상자는 칸 수의 제곱에 비례하는 전처리가 필요해서 직접 지정한 경우에만 측정한다
+	Options.Engines = ParseList<FString>(Params, TEXT("Engines="), { TEXT("JPS"), TEXT("JPSPlus"), TEXT("GraphAStar"), TEXT("GridAStar") });
+
+	int32 QueryCount = 2000;
+	int32 Seed = 1;
+	FParse::Value(*Params, TEXT("Queries="), QueryCount);
+	FParse::Value(*Params, TEXT("Seed="), Seed);
+
+	// 비교할 때 구분할 이름, 보통 커밋 해시를 넘긴다
+	FString Label = FDateTime::Now().ToString(TEXT("%Y%m%d-%H%M%S"));
+	FParse::Value(*Params, TEXT("Label="), Label);
+	FString OutDir = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Benchmarks"));
+	FParse::Value(*Params, TEXT("Out="), OutDir);
+
+	// 생성한 맵과 요청을 저장해두고 다음 실행에서 그대로 읽는다, -NoCorpus면 매번 생성한다
+	FString CorpusPath = FPaths::Combine(OutDir, TEXT("JPSBenchmark-Corpus.bin"));
+	FParse::Value(*Params, TEXT("Corpus="), CorpusPath);
+	const bool bUseCorpus = !FParse::Param(*Params, TEXT("NoCorpus"));
+	FJPSCorpus Corpus;
+	if (bUseCorpus && Corpus.Load(CorpusPath))
+	{
+		UE_LOG(LogJPSBenchmark, Display, TEXT("Loaded %d maps from %s"), Corpus.Num(), *CorpusPath);
+	}
+
+	TArray<FRunResult> Results;
+	for (int32 Size : Sizes)
+	{
+		for (float Density : Densities)
+		{
+			const FString MapName = FString::Printf(TEXT("random-%d-%.2f-%d"), Size, Density, Seed);
+			const FString EntryName = FString::Printf(TEXT("%s-q%d"), *MapName, QueryCount);
+			const FJPSCorpusEntry* Entry = Corpus.Find(EntryName);
+			if (!Entry)
+			{
+				FJPSCorpusEntry NewEntry;
+				NewEntry.Name = EntryName;
+				NewEntry.Seed = Seed;
+				NewEntry.Map = GenerateRandomMap(Size, Density, Seed);
+
+				FJPSGrid Generated;
+				Generated.Create(Size, Size);
+				Generated.ApplyBitmap(NewEntry.Map.Bitmap, NewEntry.Map.WordWidths);
+				NewEntry.Queries = MakeQueries(Generated.GetView(), QueryCount, Seed);
+				Entry = &Corpus.Add(MoveTemp(NewEntry));
+			}
+
+			FJPSGrid Grid;
+			Grid.Create(Entry->Map.Width, Entry->Map.Height);
+			Grid.ApplyBitmap(Entry->Map.Bitmap, Entry->Map.WordWidths);
+			RunMap(MapName, Grid, Density, Entry->Queries, nullptr, Options, Results);
+		}
+	}
+
+	if (bUseCorpus && Corpus.IsDirty() && Corpus.Save(CorpusPath))
+	{
+		UE_LOG(LogJPSBenchmark, Display, TEXT("Saved %d maps to %s"), Corpus.Num(), *CorpusPath);
+	}
+
+	// MovingAI 시나리오는 생성한 맵과 별도로 시나리오 파일의 요청을 그대로 쓴다
+	for (const FString& ScenarioPath : ScenarioPaths)
+	{
+		TArray<FJPSMovingAIScenario> Scenarios;
+		if (!FJPSMovingAI::LoadScenarios(ScenarioPath, Scenarios))
+		{
+			continue;
+		}
+
+		const FString MapPath = FJPSMovingAI::ResolveMapPath(ScenarioPath, Scenarios[0]);
+		FJPSMovingAIMap Map;
+		if (!FJPSMovingAI::LoadMap(MapPath, Map))
+		{
+			continue;
+		}
+
+		FJPSGrid Grid;
+		Grid.Create(Map.Width, Map.Height);
+		Grid.ApplyBitmap(Map.Bitmap, Map.WordWidths);
+
+		// 탐색은 시작과 목적지가 같은 요청을 받지 않으므로 뺀다
+		Scenarios.RemoveAll([&Map](const FJPSMovingAIScenario& InScenario)
+		{
+			return InScenario.Start == InScenario.Goal || InScenario.MapWidth != Map.Width || InScenario.MapHeight != Map.Height;
+		});
+		TArray<FPathRequest> Queries;
+		for (const FJPSMovingAIScenario& Scenario : Scenarios)
+		{
+			FPathRequest& Request = Queries.AddDefaulted_GetRef();
+			Request.Start = Scenario.Start;
+			Request.End = Scenario.Goal;
+		}
+
+		int32 Blocked = 0;
+		for (int32 Y = 0; Y < Map.Height; Y++)
+		{
+			for (int32 X = 0; X < Map.Width; X++)
+			{
+				Blocked += Map.IsCollision(X, Y) ? 1 : 0;
+			}
+		}
+		RunMap(FPaths::GetBaseFilename(MapPath), Grid, static_cast<float>(Blocked) / (Map.Width * Map.Height), Queries, &Scenarios, Options, Results);
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("label"), Label);
+	Root->SetNumberField(TEXT("seed"), Seed);
+	Root->SetNumberField(TEXT("queries"), QueryCount);
+	Root->SetNumberField(TEXT("worker_threads"), Options.MaxThreads);
+	TArray<TSharedPtr<FJsonValue>> JsonResults;
+	FString Csv = FString(CsvHeader) + LINE_TERMINATOR;
+	for (const FRunResult& Result : Results)
+	{
+		JsonResults.Add(MakeShared<FJsonValueObject>(ToJson(Result)));
+		Csv += ToCsv(Result) + LINE_TERMINATOR;
+	}
+	Root->SetArrayField(TEXT("results"), JsonResults);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+
+	const FString BaseName = FPaths::Combine(OutDir, FString::Printf(TEXT("JPSBenchmark-%s"), *Label));
+	if (!FFileHelper::SaveStringToFile(Json, *(BaseName + TEXT(".json"))) || !FFileHelper::SaveStringToFile(Csv, *(BaseName + TEXT(".csv"))))
+	{
+		UE_LOG(LogJPSBenchmark, Error, TEXT("Failed to write %s"), *BaseName);
+		return 1;
+	}
+
+	UE_LOG(LogJPSBenchmark, Display, TEXT("Wrote %d results to %s.json/.csv"), Results.Num(), *BaseName);
+	return 0;
+}
@@ -5,6 +5,7 @@
 #include "JPSPath.h"
 
 #include "TDBitArray.h"
+#include "Async/Async.h"
 #include "NavigationSystem.h"
 #include "AI/Navigation/NavigationTypes.h"
 
@@ -14,6 +15,51 @@ AJPSCollision::AJPSCollision()
 	JPSPathfinder = CreateDefaultSubobject<UJPSPath>(TEXT("JPSPath"));
 	Width = 32;
 	Height = 32;
+	OpenListType = EJPSOpenListType::BinaryHeap;
+	bUseJPSPlus = false;
+	bUseGoalBounds = false;
+	MaxAsyncPathTasks = 4;
+	AsyncPathStepExpansions = 256;
+	PathCacheCapacity = 256;
+}
+
+void FJPSMapChange::AddDirtyRect(const FIntRect& InRect)
+{
+	// 합친 사각형이 다른 사각형과 새로 닿을 수 있으므로 더 합칠 것이 없을 때까지 처음부터 다시 검사한다
+	FIntRect Merged = InRect;
+	for (int32 Index = 0; Index < DirtyRects.Num();)
+	{
+		const FIntRect& Rect = DirtyRects[Index];
+		const bool IsTouching = Rect.Min.X <= Merged.Max.X && Merged.Min.X <= Rect.Max.X && Rect.Min.Y <= Merged.Max.Y && Merged.Min.Y <= Rect.Max.Y;
+		if (IsTouching)
+		{
+			Merged.Min = Merged.Min.ComponentMin(Rect.Min);
+			Merged.Max = Merged.Max.ComponentMax(Rect.Max);
+			DirtyRects.RemoveAtSwap(Index);
+			Index = 0;
+		}
+		else
+		{
+			Index++;
+		}
+	}
+	DirtyRects.Add(Merged);
+}
+
+void FJPSMapChange::Append(const FJPSMapChange& InChange)
+{
+	Version = FMath::Max(Version, InChange.Version);
+	bFullRebuild |= InChange.bFullRebuild;
+	for (const FIntRect& Rect : InChange.DirtyRects)
+	{
+		AddDirtyRect(Rect);
+	}
+}
+
+// 우선순위가 높고 먼저 요청된 탐색이 힙의 위로 온다
+static bool AsyncPathPredicate(const FJPSAsyncPathRequest& InA, const FJPSAsyncPathRequest& InB)
+{
+	return InA.Priority != InB.Priority ? InA.Priority > InB.Priority : InA.Handle.Id < InB.Handle.Id;
 }
 
 void AJPSCollision::BeginPlay()
@@ -21,283 +67,266 @@ void AJPSCollision::BeginPlay()
 	Super::BeginPlay();
 }
 
+void AJPSCollision::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CancelAllPaths();
+	WaitForAsyncPaths();
+	DrainAsyncPaths();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AJPSCollision::BeginDestroy()
+{
+	// 워커가 탐색중인 맵과 컨텍스트가 해제되지 않도록 기다린다
+	CancelAllPaths();
+	WaitForAsyncPaths();
+	DrainAsyncPaths();
+
+	Super::BeginDestroy();
+}
+
 bool AJPSCollision::CreateMap()
 {
-	// X축 방향 2차원 비트배열 초기화
-	XBoundaryPoints.Empty();
-	XBoundaryPoints.Create(Width, Height);
-	// Y축 방향 2차원 비트배열 초기화
-	YBoundaryPoints.Empty();
-	YBoundaryPoints.Create(Height, Width);
+	BeginMapWrite();
+	BitGrid.Create(Width, Height);
 
-	// 비트배열의 가로 크기보다 맵의 길이가 적게 설정되기 때문에 사용하지 않는 부분을 충돌지점으로 바꾼다
-	for (int GridX = Width; GridX < XBoundaryPoints.GetBitsWidths(); GridX++)
+	// 비트배열을 새로 할당했기 때문에 탐색이 들고 있는 뷰를 갱신한다
+	if (IsValid(JPSPathfinder))
 	{
-		for (int GridY = Height; GridY < YBoundaryPoints.GetBitsWidths(); GridY++)
-		{
-			SetAt(GridX, GridY);
-		}
+		JPSPathfinder->SetMap(this);
 	}
+	MarkFullRebuild();
 	return true;
 }
 
 bool AJPSCollision::IsOutBound(int32 InX, int32 InY) const
 {
-	if (InX < 0)
+	return BitGrid.IsOutBound(InX, InY);
+}
+
+bool AJPSCollision::IsCollision(int32 InX, int32 InY) const
+{
+	return BitGrid.IsCollision(InX, InY);
+}
+
+void AJPSCollision::SetAt(int32 InX, int32 InY)
+{
+	WriteCell(InX, InY, true);
+}
+
+void AJPSCollision::ClearAt(int32 InX, int32 InY)
+{
+	WriteCell(InX, InY, false);
+}
+
+void AJPSCollision::SetRect(int32 InX, int32 InY, int32 InWidth, int32 InHeight)
+{
+	FillRect(InX, InY, InWidth, InHeight, true);
+}
+
+void AJPSCollision::ClearRect(int32 InX, int32 InY, int32 InWidth, int32 InHeight)
+{
+	FillRect(InX, InY, InWidth, InHeight, false);
+}
+
+bool AJPSCollision::ApplyBitmap(TConstArrayView<uint64> InBitmap, int32 InWordWidths)
+{
+	BeginMapWrite();
+	const bool IsApplied = BitGrid.ApplyBitmap(InBitmap, InWordWidths);
+	if (IsApplied)
 	{
-		return true;
+		MarkFullRebuild();
 	}
-	if (InY < 0)
+	return IsApplied;
+}
+
+void AJPSCollision::FillRect(int32 InX, int32 InY, int32 InWidth, int32 InHeight, bool InFlag)
+{
+	BeginMapWrite();
+	BitGrid.FillRect(InX, InY, InWidth, InHeight, InFlag);
+
+	FIntRect Rect(InX, InY, InX + InWidth, InY + InHeight);
+	Rect.Clip(FIntRect(0, 0, BitGrid.GetWidth(), BitGrid.GetHeight()));
+	if (Rect.Area() > 0)
 	{
-		return true;
+		MarkDirty(Rect, InFlag);
 	}
-	if (InX >= Width)
+}
+
+void AJPSCollision::BuildMap()
+{
+	if (IsValid(JPSPathfinder))
 	{
-		return true;
+		JPSPathfinder->SetOpenListType(OpenListType);
 	}
-	if (InY >= Height)
+	CreateMap();
+}
+
+void AJPSCollision::SetOpenListType(EJPSOpenListType InType)
+{
+	StopAsyncPaths();
+	OpenListType = InType;
+	// 다른 오픈리스트로 잰 시간과 통계가 이전 결과로 채워지지 않도록 캐시를 비운다
+	PathCache.Reset();
+	if (IsValid(JPSPathfinder))
 	{
-		return true;
+		JPSPathfinder->SetOpenListType(OpenListType);
 	}
-	return false;
 }
 
-bool AJPSCollision::IsCollision(int32 InX, int32 InY)
+bool AJPSCollision::BuildJPSPlus()
 {
-	return XBoundaryPoints.IsSet(InX, InY);
+	if (!IsValid(JPSPathfinder))
+	{
+		return false;
+	}
+
+	StopAsyncPaths();
+	return JPSPathfinder->BuildJumpTable();
 }
 
-void AJPSCollision::SetAt(int32 InX, int32 InY)
+bool AJPSCollision::BuildGoalBounds()
 {
-	XBoundaryPoints.SetAt(InX, InY, true);
-	YBoundaryPoints.SetAt(InY, InX, true);
+	if (!IsValid(JPSPathfinder))
+	{
+		return false;
+	}
+
+	StopAsyncPaths();
+	return JPSPathfinder->BuildGoalBounds();
 }
 
-void AJPSCollision::ClearAt(int32 InX, int32 InY)
+void AJPSCollision::WriteCell(int32 InX, int32 InY, bool InFlag)
 {
-	XBoundaryPoints.SetAt(InX, InY, false);
-	YBoundaryPoints.SetAt(InY, InX, false);
-}
-
-int32 AJPSCollision::GetCloseValue(int32 InX, int32 InY, bool IsXaxis, bool IsForward)
-{
-	// uint64의 비트 64개가 모두 1인 상태부터 맨 오른쪽 비트부터 한 칸씩 시프트하여 10000000~까지를 가지는 배열 (양방향)
-	// 1111 -> 1110 -> 1100 -> 1000
-	static const uint64 PlusTable[] = 
-	{
-		18446744073709551615ULL,		18446744073709551614ULL,		18446744073709551612ULL,		18446744073709551608ULL,
-		18446744073709551600ULL,		18446744073709551584ULL,		18446744073709551552ULL,		18446744073709551488ULL,
-		18446744073709551360ULL,		18446744073709551104ULL,		18446744073709550592ULL,		18446744073709549568ULL,
-		18446744073709547520ULL,		18446744073709543424ULL,		18446744073709535232ULL,		18446744073709518848ULL,
-		18446744073709486080ULL,		18446744073709420544ULL,		18446744073709289472ULL,		18446744073709027328ULL,
-		18446744073708503040ULL,		18446744073707454464ULL,		18446744073705357312ULL,		18446744073701163008ULL,
-		18446744073692774400ULL,		18446744073675997184ULL,		18446744073642442752ULL,		18446744073575333888ULL,
-		18446744073441116160ULL,		18446744073172680704ULL,		18446744072635809792ULL,		18446744071562067968ULL,
-		18446744069414584320ULL,		18446744065119617024ULL,		18446744056529682432ULL,		18446744039349813248ULL,
-		18446744004990074880ULL,		18446743936270598144ULL,		18446743798831644672ULL,		18446743523953737728ULL,
-		18446742974197923840ULL,		18446741874686296064ULL,		18446739675663040512ULL,		18446735277616529408ULL,
-		18446726481523507200ULL,		18446708889337462784ULL,		18446673704965373952ULL,		18446603336221196288ULL,
-		18446462598732840960ULL,		18446181123756130304ULL,		18445618173802708992ULL,		18444492273895866368ULL,
-		18442240474082181120ULL,		18437736874454810624ULL,		18428729675200069632ULL,		18410715276690587648ULL,
-		18374686479671623680ULL,		18302628885633695744ULL,		18158513697557839872ULL,		17870283321406128128ULL,
-		17293822569102704640ULL,		16140901064495857664ULL,		13835058055282163712ULL,		9223372036854775808ULL,
-	};
-
-	// 위와 반대로 오른쪽부터 역방향으로 간다
-	// 0001 -> 0011 -> 0111 -> 1111
-	static const uint64 MinusTable[] = 
-	{
-		1ULL,						3ULL,						7ULL,						15ULL,
-		31ULL,						63ULL,						127ULL,						255ULL,
-		511ULL,						1023ULL,					2047ULL,					4095ULL,
-		8191ULL,					16383ULL,					32767ULL,					65535ULL,
-		131071ULL,					262143ULL,					524287ULL,					1048575ULL,
-		2097151ULL,					4194303ULL,					8388607ULL,					16777215ULL,
-		33554431ULL,				67108863ULL,				134217727ULL,				268435455ULL,
-		536870911ULL,				1073741823ULL,				2147483647ULL,				4294967295ULL,
-		8589934591ULL,				17179869183ULL,				34359738367ULL,				68719476735ULL,
-		137438953471ULL,			274877906943ULL,			549755813887ULL,			1099511627775ULL,
-		2199023255551ULL,			4398046511103ULL,			8796093022207ULL,			17592186044415ULL,
-		35184372088831ULL,			70368744177663ULL,			140737488355327ULL,			281474976710655ULL,
-		562949953421311ULL,			1125899906842623ULL,		2251799813685247ULL,		4503599627370495ULL,
-		9007199254740991ULL,		18014398509481983ULL,		36028797018963967ULL,		72057594037927935ULL,
-		144115188075855871ULL,		288230376151711743ULL,		576460752303423487ULL,		1152921504606846975ULL,
-		2305843009213693951ULL,		4611686018427387903ULL,		9223372036854775807ULL,		18446744073709551615ULL,
-	};
-
-
-	int32 MaxValue = IsXaxis ? Width : Height;
-	TDBitArray<int64>& MaskBound = IsXaxis ? XBoundaryPoints : YBoundaryPoints;
-	int32 Variable = IsXaxis ? InX : InY;
-	int32 NBitmask = IsXaxis ? XBoundaryPoints.NBITMASK : YBoundaryPoints.NBITMASK;
-	if (IsForward)
-	{
-		// 행의 원소 수
-		int32 MaxWidths = MaskBound.GetWordWidths();
-		for (int i = 0; i < MaxWidths; ++i)
-		{
-			// 좌표를 1차원 위치로 변환, 원소 단위로 검사하기때문에 i에 원소의 비트수만큼 곱해준다
-			int32 Pos = IsXaxis ? GetPosX(InX + i * NBitmask, InY) : GetPosY(InX, InY + i * NBitmask);
-			if (Pos == NPos)
-			{
-				return MaxValue;
-			}
-
-			// 선택된 원소
-			int64 Value = MaskBound[Pos / NBitmask];
-			// 선택된 원소가 시작위치가 포함된 원소라면 플러스테이블과 and연산을 해서 시작위치 이전의 값들을 모두 0으로 바꾼다
-			// 비트수가 64이고 맵크기가 100이면 한 행에 원소는 128개 x좌표가 10이면 10번째 원소 
-			if (i == 0)
-			{
-				Value &= PlusTable[(Variable % NBitmask)];
-			}
+	StopAsyncPaths();
+	const bool IsChanged = BitGrid.SetAt(InX, InY, InFlag);
+	if (!IsChanged)
+	{
+		return;
+	}
 
-			unsigned long index = 0;
-			if (AJPSCollision::BitScanForward64(index, Value))
-			{
-				// 가장 가까운 충돌지점 반환
-				// 00000x000000 000000000ㅁ11
-				return (Variable - (Variable % NBitmask) + i * NBitmask) + index;
-			}
+	if (IsValid(JPSPathfinder))
+	{
+		// 테이블이 있으면 전부 다시 만들지 않고 바뀐 칸 주변만 고친다
+		if (JPSPathfinder->HasJumpTable())
+		{
+			JPSPathfinder->RepairJumpTable(InX, InY);
 		}
-		// 없다면 마지막 반환
-		return MaxValue;
+		JPSPathfinder->ResetGoalBounds();
 	}
-	else
+	MarkDirty(FIntRect(InX, InY, InX + 1, InY + 1), InFlag);
+}
+
+void AJPSCollision::BeginMapWrite()
+{
+	StopAsyncPaths();
+	if (IsValid(JPSPathfinder))
 	{
-		int32 MaxWidths = MaskBound.GetWordWidths();
-		for (int i = 0; i < MaxWidths; ++i)
-		{
-			int32 Pos = IsXaxis ? GetPosX(InX - i * NBitmask, InY) : GetPosY(InX, InY - i * NBitmask);
-			if (Pos == NPos)
-			{
-				return -1;
-			}
+		JPSPathfinder->ResetJumpTable();
+		JPSPathfinder->ResetGoalBounds();
+	}
+}
 
-			int64 Value = MaskBound[Pos / NBitmask];
-			if (i == 0)
-			{
-				Value &= MinusTable[(Variable % NBitmask)];
-			}
+void AJPSCollision::BeginMapEdit()
+{
+	MapEditDepth++;
+}
 
-			unsigned long index = 0;
-			if (AJPSCollision::BitScanReverse64(index, Value))
-			{
-				return (Variable - (Variable % NBitmask) - i * NBitmask) + index;
-			}
-		}
-		return -1;
-	}
-}
-
-int32 AJPSCollision::GetOpenValue(int32 InX, int32 InY, bool IsXaxis, bool IsForward)
-{
-	static const uint64 PlusTable[] =
-	{
-		18446744073709551615ULL,		18446744073709551614ULL,		18446744073709551612ULL,		18446744073709551608ULL,
-		18446744073709551600ULL,		18446744073709551584ULL,		18446744073709551552ULL,		18446744073709551488ULL,
-		18446744073709551360ULL,		18446744073709551104ULL,		18446744073709550592ULL,		18446744073709549568ULL,
-		18446744073709547520ULL,		18446744073709543424ULL,		18446744073709535232ULL,		18446744073709518848ULL,
-		18446744073709486080ULL,		18446744073709420544ULL,		18446744073709289472ULL,		18446744073709027328ULL,
-		18446744073708503040ULL,		18446744073707454464ULL,		18446744073705357312ULL,		18446744073701163008ULL,
-		18446744073692774400ULL,		18446744073675997184ULL,		18446744073642442752ULL,		18446744073575333888ULL,
-		18446744073441116160ULL,		18446744073172680704ULL,		18446744072635809792ULL,		18446744071562067968ULL,
-		18446744069414584320ULL,		18446744065119617024ULL,		18446744056529682432ULL,		18446744039349813248ULL,
-		18446744004990074880ULL,		18446743936270598144ULL,		18446743798831644672ULL,		18446743523953737728ULL,
-		18446742974197923840ULL,		18446741874686296064ULL,		18446739675663040512ULL,		18446735277616529408ULL,
-		18446726481523507200ULL,		18446708889337462784ULL,		18446673704965373952ULL,		18446603336221196288ULL,
-		18446462598732840960ULL,		18446181123756130304ULL,		18445618173802708992ULL,		18444492273895866368ULL,
-		18442240474082181120ULL,		18437736874454810624ULL,		18428729675200069632ULL,		18410715276690587648ULL,
-		18374686479671623680ULL,		18302628885633695744ULL,		18158513697557839872ULL,		17870283321406128128ULL,
-		17293822569102704640ULL,		16140901064495857664ULL,		13835058055282163712ULL,		9223372036854775808ULL,
-	};
-
-	static const uint64 MinusTable[] =
-	{
-		1ULL,						3ULL,						7ULL,						15ULL,
-		31ULL,						63ULL,						127ULL,						255ULL,
-		511ULL,						1023ULL,					2047ULL,					4095ULL,
-		8191ULL,					16383ULL,					32767ULL,					65535ULL,
-		131071ULL,					262143ULL,					524287ULL,					1048575ULL,
-		2097151ULL,					4194303ULL,					8388607ULL,					16777215ULL,
-		33554431ULL,				67108863ULL,				134217727ULL,				268435455ULL,
-		536870911ULL,				1073741823ULL,				2147483647ULL,				4294967295ULL,
-		8589934591ULL,				17179869183ULL,				34359738367ULL,				68719476735ULL,
-		137438953471ULL,			274877906943ULL,			549755813887ULL,			1099511627775ULL,
-		2199023255551ULL,			4398046511103ULL,			8796093022207ULL,			17592186044415ULL,
-		35184372088831ULL,			70368744177663ULL,			140737488355327ULL,			281474976710655ULL,
-		562949953421311ULL,			1125899906842623ULL,		2251799813685247ULL,		4503599627370495ULL,
-		9007199254740991ULL,		18014398509481983ULL,		36028797018963967ULL,		72057594037927935ULL,
-		144115188075855871ULL,		288230376151711743ULL,		576460752303423487ULL,		1152921504606846975ULL,
-		2305843009213693951ULL,		4611686018427387903ULL,		9223372036854775807ULL,		18446744073709551615ULL,
-	};
-
-
-	int32 MaxValue = IsXaxis ? Width : Height;
-	TDBitArray<int64>& MaskBound = IsXaxis ? XBoundaryPoints : YBoundaryPoints;
-	int32 Variable = IsXaxis ? InX : InY;
-	int32 NBitmask = IsXaxis ? XBoundaryPoints.NBITMASK : YBoundaryPoints.NBITMASK;
-	if (IsForward)
-	{
-		int32 MaxWidths = MaskBound.GetWordWidths();
-		for (int i = 0; i < MaxWidths; ++i)
-		{
-			int32 Pos = IsXaxis ? GetPosX(InX + i * NBitmask, InY) : GetPosY(InX, InY + i * NBitmask);
-			if (Pos == NPos)
-			{
-				return MaxValue;
-			}
+void AJPSCollision::EndMapEdit()
+{
+	if (MapEditDepth > 0 && --MapEditDepth == 0)
+	{
+		CommitMapChange();
+	}
+}
 
-			// 현재값의 반대 비트값을 부여해서 가장 가까운 오픈지점을 탐색
-			int64 Value = ~MaskBound[Pos / NBitmask];
-			if (i == 0)
-			{
-				Value &= PlusTable[(Variable % NBitmask)];
-			}
+void AJPSCollision::OpenMapChange()
+{
+	// 수정 하나의 첫 변경에서 버전을 올리고 EndMapEdit까지 같은 버전을 쓴다
+	if (!bPendingChange)
+	{
+		PendingChange = FJPSMapChange();
+		PendingChange.Version = ++MapVersion;
+		bPendingChange = true;
+	}
+}
 
-			unsigned long index = 0;
-			if (AJPSCollision::BitScanForward64(index, Value))
-			{
-				return (Variable - (Variable % NBitmask) + i * NBitmask) + index;
-			}
-		}
-		return MaxValue;
+void AJPSCollision::MarkDirty(const FIntRect& InRect, bool InBlocked)
+{
+	OpenMapChange();
+	PendingChange.AddDirtyRect(InRect);
+	PathCache.Invalidate(InRect, InBlocked, MapVersion);
+
+	if (MapEditDepth == 0)
+	{
+		CommitMapChange();
 	}
-	else
+}
+
+void AJPSCollision::MarkFullRebuild()
+{
+	OpenMapChange();
+	PendingChange.bFullRebuild = true;
+	PendingChange.DirtyRects.Reset();
+	PendingChange.AddDirtyRect(FIntRect(0, 0, BitGrid.GetWidth(), BitGrid.GetHeight()));
+	PathCache.Reset();
+
+	if (MapEditDepth == 0)
 	{
-		int32 MaxWidths = MaskBound.GetWordWidths();
-		for (int i = 0; i < MaxWidths; ++i)
-		{
-			int32 Pos = IsXaxis ? GetPosX(InX - i * NBitmask, InY) : GetPosY(InX, InY - i * NBitmask);
-			if (Pos == NPos)
-			{
-				return -1;
-			}
+		CommitMapChange();
+	}
+}
 
-			int64 Value = ~MaskBound[Pos / NBitmask];
-			if (i == 0)
-			{
-				Value &= MinusTable[(Variable % NBitmask)];
-			}
+void AJPSCollision::CommitMapChange()
+{
+	if (!bPendingChange)
+	{
+		return;
+	}
+	bPendingChange = false;
 
-			unsigned long index = 0;
-			if (AJPSCollision::BitScanReverse64(index, Value))
-			{
-				return (Variable - (Variable % NBitmask) - i * NBitmask) + index;
-			}
-		}
-		return -1;
+	if (ChangeHistory.Num() >= MaxChangeHistory)
+	{
+		ChangeHistory.RemoveAt(0);
 	}
+	ChangeHistory.Add(PendingChange);
+
+	// 받는 쪽에서 맵을 다시 바꿀 수 있으므로 복사해서 넘긴다
+	const FJPSMapChange Change = PendingChange;
+	MapChanged.Broadcast(Change);
 }
 
-void AJPSCollision::BuildMap()
+bool AJPSCollision::GetChangesSince(uint32 InVersion, FJPSMapChange& OutChange) const
 {
-	CreateMap();
+	OutChange = FJPSMapChange();
+	OutChange.Version = MapVersion;
+	if (InVersion >= MapVersion)
+	{
+		return true;
+	}
 
-	if (IsValid(JPSPathfinder))
+	// 가장 오래된 기록이 InVersion 바로 다음 버전보다 뒤면 그 사이의 변경을 알 수 없다
+	const uint32 OldestVersion = ChangeHistory.Num() > 0 ? ChangeHistory[0].Version : (bPendingChange ? PendingChange.Version : MapVersion + 1);
+	if (OldestVersion > InVersion + 1)
 	{
-		JPSPathfinder->SetMap(this);
+		OutChange.bFullRebuild = true;
+		OutChange.AddDirtyRect(FIntRect(0, 0, BitGrid.GetWidth(), BitGrid.GetHeight()));
+		return false;
 	}
+
+	for (const FJPSMapChange& Change : ChangeHistory)
+	{
+		if (Change.Version > InVersion)
+		{
+			OutChange.Append(Change);
+		}
+	}
+	if (bPendingChange)
+	{
+		OutChange.Append(PendingChange);
+	}
+	return true;
 }
 
 void AJPSCollision::FindPath(FIntPoint InStartCoord, FIntPoint InEndCoord, TArray<FIntPoint>& OutResultPos)
@@ -308,120 +337,264 @@ void AJPSCollision::FindPath(FIntPoint InStartCoord, FIntPoint InEndCoord, TArra
 		return;
 	}
 
-	JPSPathfinder->Search(InStartCoord, InEndCoord, OutResultPos);
+	// 탐색은 막힌 칸에서도 출발할 수 있어서 뒤집은 요청과 결과가 다르므로 양 끝이 이동 가능할 때만 캐시한다
+	PathCache.SetCapacity(PathCacheCapacity);
+	const bool IsCacheable = !IsCollision(InStartCoord.X, InStartCoord.Y) && !IsCollision(InEndCoord.X, InEndCoord.Y);
+	if (IsCacheable && PathCache.Find(InStartCoord, InEndCoord, MapVersion, OutResultPos))
+	{
+		return;
+	}
+
+	if (JPSPathfinder->Search(InStartCoord, InEndCoord, OutResultPos) && IsCacheable)
+	{
+		PathCache.Add(InStartCoord, InEndCoord, MapVersion, OutResultPos);
+	}
+}
+
+FJPSSearchStats AJPSCollision::GetLastSearchStats() const
+{
+	return IsValid(JPSPathfinder) ? JPSPathfinder->GetLastSearchStats() : FJPSSearchStats();
 }
 
-int32 AJPSCollision::GetPosX(int32 InX, int32 InY)
+void AJPSCollision::FindPathBatch(TConstArrayView<FPathRequest> InRequests, TArrayView<FPathResult> OutResults)
 {
-	if (InX < 0 || InX >= Width || InY < 0 || InY >= Height)
+	if (!IsValid(JPSPathfinder))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Not Exist JPSPathfinder"));
+		return;
+	}
+
+	JPSPathfinder->FindPathBatch(InRequests, OutResults);
+	for (FPathResult& Result : OutResults)
 	{
-		return NPos;
+		Result.MapVersion = MapVersion;
 	}
-	return InX + InY * XBoundaryPoints.GetBitsWidths();
 }
 
-int32 AJPSCollision::GetPosY(int32 InX, int32 InY)
+FJPSPathHandle AJPSCollision::RequestPathAsync(FIntPoint InStartCoord, FIntPoint InEndCoord, FOnJPSPathComplete InOnComplete, int32 InPriority)
 {
-	if (InX < 0 || InX >= Width || InY < 0 || InY >= Height)
+	return EnqueuePath(InStartCoord, InEndCoord, InPriority, MoveTemp(InOnComplete), nullptr);
+}
+
+TFuture<FPathResult> AJPSCollision::RequestPathFuture(FIntPoint InStartCoord, FIntPoint InEndCoord, int32 InPriority, FJPSPathHandle* OutHandle)
+{
+	TSharedPtr<TPromise<FPathResult>> Promise = MakeShared<TPromise<FPathResult>>();
+	TFuture<FPathResult> Future = Promise->GetFuture();
+	FJPSPathHandle Handle = EnqueuePath(InStartCoord, InEndCoord, InPriority, FOnJPSPathComplete(), MoveTemp(Promise));
+	if (OutHandle)
 	{
-		return NPos;
+		*OutHandle = Handle;
 	}
-	return InX * YBoundaryPoints.GetBitsWidths() + InY;
+	return Future;
 }
 
-bool AJPSCollision::BitScanReverse64(unsigned long& InIndex, uint64 InWord)
+FJPSPathHandle AJPSCollision::EnqueuePath(FIntPoint InStartCoord, FIntPoint InEndCoord, int32 InPriority, FOnJPSPathComplete&& InOnComplete, TSharedPtr<TPromise<FPathResult>>&& InPromise)
 {
-	// 맨 마지막 비트 인덱스부터 가장 처음 비트가 1인 곳을 찾는 함수
-	unsigned long Num = 63;
-	if (!InWord)
+	check(IsInGameThread());
+
+	FJPSAsyncPathRequest Request;
+	// 0은 유효하지 않은 핸들이므로 건너뛴다
+	if (++LastPathId == 0)
 	{
-		return false;
+		++LastPathId;
 	}
+	Request.Handle.Id = LastPathId;
+	Request.Priority = InPriority;
+	Request.Request.Start = InStartCoord;
+	Request.Request.End = InEndCoord;
+	Request.OnComplete = MoveTemp(InOnComplete);
+	Request.Promise = MoveTemp(InPromise);
+
+	FJPSPathHandle Handle = Request.Handle;
+	PendingPaths.HeapPush(MoveTemp(Request), AsyncPathPredicate);
+	DispatchAsyncPaths();
+	return Handle;
+}
 
-	if (!(InWord & 0xffffffff00000000ULL)) 
+void AJPSCollision::DispatchAsyncPaths()
+{
+	if (!IsValid(JPSPathfinder))
 	{
-		InWord <<= 32;
-		Num -= 32;
+		return;
 	}
 
-	if (!(InWord & 0xffff000000000000ULL)) 
+	while (PendingPaths.Num() > 0 && RunningPaths.Num() < FMath::Max(MaxAsyncPathTasks, 1))
 	{
-		InWord <<= 16;
-		Num -= 16;
+		FJPSAsyncPathRequest Request;
+		PendingPaths.HeapPop(Request, AsyncPathPredicate);
+
+		// 요청마다 빈 컨텍스트에서 탐색하기 때문에 결과는 실행 순서나 스레드에 관계없이 같다
+		const uint32 Id = Request.Handle.Id;
+		const FPathRequest Query = Request.Request;
+		FJPSSearchContext* Context = JPSPathfinder->AcquireContext();
+		const FJPSPathfinder* Pathfinder = &JPSPathfinder->GetPathfinder();
+		TWeakObjectPtr<AJPSCollision> WeakThis(this);
+		TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> StopFlag = MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+		FJPSSearchBudget Budget;
+		Budget.MaxExpansions = FMath::Max(AsyncPathStepExpansions, 1);
+
+		Request.Context = Context;
+		Request.StopFlag = StopFlag;
+		Request.MapVersion = MapVersion;
+		Request.Task = Async(EAsyncExecution::ThreadPool, [Pathfinder, Context, Query, Id, WeakThis, StopFlag, Budget]()
+		{
+			// 단계 사이에서만 멈추기 때문에 멈춘 뒤에는 맵과 테이블을 읽지 않는다
+			FPathResult Result;
+			bool IsStopped = false;
+			if (Pathfinder->BeginSearch(*Context, Query.Start, Query.End))
+			{
+				EJPSSearchStatus Status = EJPSSearchStatus::InProgress;
+				while (Status == EJPSSearchStatus::InProgress)
+				{
+					if (StopFlag->load())
+					{
+						IsStopped = true;
+						break;
+					}
+					Status = Pathfinder->StepSearch(*Context, Budget, Result.Path);
+				}
+				Result.bFound = Status == EJPSSearchStatus::Found;
+			}
+
+			AsyncTask(ENamedThreads::GameThread, [WeakThis, Id, IsStopped, Result = MoveTemp(Result)]() mutable
+			{
+				if (AJPSCollision* This = WeakThis.Get())
+				{
+					This->OnAsyncPathFinished(Id, IsStopped, MoveTemp(Result));
+				}
+			});
+		});
+		RunningPaths.Add(Id, MoveTemp(Request));
 	}
+}
 
-	if (!(InWord & 0xff00000000000000ULL))
+void AJPSCollision::OnAsyncPathFinished(uint32 InId, bool InStopped, FPathResult&& InResult)
+{
+	FJPSAsyncPathRequest Request;
+	if (!RunningPaths.RemoveAndCopyValue(InId, Request))
 	{
-		InWord <<= 8;
-		Num -= 8;
+		return;
 	}
 
-	if (!(InWord & 0xf000000000000000ULL))
+	if (IsValid(JPSPathfinder))
 	{
-		InWord <<= 4;
-		Num -= 4;
+		JPSPathfinder->ReleaseContext(Request.Context);
 	}
+	Request.Context = nullptr;
+	Request.Task = TFuture<void>();
+	Request.StopFlag.Reset();
 
-	if (!(InWord & 0xc000000000000000ULL)) 
+	if (Request.bCancelled)
+	{
+		InResult = FPathResult();
+	}
+	else if (InStopped || Request.MapVersion != MapVersion)
+	{
+		// 맵이 바뀌어서 멈춘 탐색이나 끝난 뒤 알리기 전에 맵이 바뀐 결과는 같은 핸들로 다시 대기열에 넣는다
+		// 핸들 순서를 유지하므로 같은 우선순위 안에서 앞쪽으로 간다
+		PendingPaths.HeapPush(MoveTemp(Request), AsyncPathPredicate);
+		DispatchAsyncPaths();
+		return;
+	}
+	else
 	{
-		InWord <<= 2;
-		Num -= 2;
+		InResult.MapVersion = Request.MapVersion;
+		Request.OnComplete.ExecuteIfBound(Request.Handle, InResult);
 	}
 
-	if (!(InWord & 0x8000000000000000ULL))
+	if (Request.Promise.IsValid())
 	{
-		InWord <<= 1;
-		Num -= 1;
+		Request.Promise->SetValue(MoveTemp(InResult));
 	}
 
-	InIndex = Num;
-	return true;
+	DispatchAsyncPaths();
 }
 
-bool AJPSCollision::BitScanForward64(unsigned long& InIndex, uint64 InWord)
+bool AJPSCollision::CancelPath(FJPSPathHandle InHandle)
 {
-	// 맨 처음 비트 인덱스부터 가장 처음 비트가 1인 곳을 찾는 함수
-	unsigned long Num = 0;
-	if (!InWord)
+	if (FJPSAsyncPathRequest* Running = RunningPaths.Find(InHandle.Id))
 	{
-		return false;
+		// 워커는 다음 단계 전에 멈추고 결과는 완료 알림에서 버린다
+		Running->bCancelled = true;
+		Running->StopFlag->store(true);
+		return true;
 	}
-		
-	if ((InWord & 0xffffffffULL) == 0) 
+
+	int32 Index = PendingPaths.IndexOfByPredicate([InHandle](const FJPSAsyncPathRequest& InRequest) { return InRequest.Handle == InHandle; });
+	if (Index == INDEX_NONE)
 	{
-		Num += 32;
-		InWord >>= 32;
+		return false;
 	}
 
-	if ((InWord & 0xffffULL) == 0) 
+	FJPSAsyncPathRequest Request = MoveTemp(PendingPaths[Index]);
+	PendingPaths.HeapRemoveAt(Index, AsyncPathPredicate);
+	if (Request.Promise.IsValid())
 	{
-		Num += 16;
-		InWord >>= 16;
+		Request.Promise->SetValue(FPathResult());
 	}
+	return true;
+}
 
-	if ((InWord & 0xffULL) == 0)
+void AJPSCollision::CancelAllPaths()
+{
+	for (TPair<uint32, FJPSAsyncPathRequest>& Running : RunningPaths)
 	{
-		Num += 8;
-		InWord >>= 8;
+		Running.Value.bCancelled = true;
+		Running.Value.StopFlag->store(true);
 	}
 
-	if ((InWord & 0xfULL) == 0)
+	TArray<FJPSAsyncPathRequest> Cancelled = MoveTemp(PendingPaths);
+	PendingPaths.Reset();
+	for (FJPSAsyncPathRequest& Request : Cancelled)
 	{
-		Num += 4;
-		InWord >>= 4;
+		if (Request.Promise.IsValid())
+		{
+			Request.Promise->SetValue(FPathResult());
+		}
 	}
+}
+
+bool AJPSCollision::IsPathPending(FJPSPathHandle InHandle) const
+{
+	return RunningPaths.Contains(InHandle.Id) || PendingPaths.ContainsByPredicate([InHandle](const FJPSAsyncPathRequest& InRequest) { return InRequest.Handle == InHandle; });
+}
 
-	if ((InWord & 0x3ULL) == 0) 
+void AJPSCollision::StopAsyncPaths()
+{
+	for (TPair<uint32, FJPSAsyncPathRequest>& Running : RunningPaths)
 	{
-		Num += 2;
-		InWord >>= 2;
+		Running.Value.StopFlag->store(true);
 	}
+	WaitForAsyncPaths();
+}
 
-	if ((InWord & 0x1ULL) == 0)
+void AJPSCollision::WaitForAsyncPaths()
+{
+	// 완료 알림은 게임 스레드 작업으로 따로 전달되기 때문에 여기서는 탐색이 끝나기만 기다린다
+	for (TPair<uint32, FJPSAsyncPathRequest>& Running : RunningPaths)
 	{
-		Num += 1;
+		if (Running.Value.Task.IsValid())
+		{
+			Running.Value.Task.Wait();
+		}
 	}
+}
 
-	InIndex = Num;
-	return true;
+void AJPSCollision::DrainAsyncPaths()
+{
+	// 액터가 사라지면 게임 스레드로 보낸 완료 알림이 OnAsyncPathFinished까지 오지 않으므로 여기서 끝낸다
+	TMap<uint32, FJPSAsyncPathRequest> Running = MoveTemp(RunningPaths);
+	RunningPaths.Reset();
+	for (TPair<uint32, FJPSAsyncPathRequest>& Pair : Running)
+	{
+		FJPSAsyncPathRequest& Request = Pair.Value;
+		if (IsValid(JPSPathfinder))
+		{
+			JPSPathfinder->ReleaseContext(Request.Context);
+		}
+		if (Request.Promise.IsValid())
+		{
+			Request.Promise->SetValue(FPathResult());
+		}
+	}
 }
@@ -2,3 +2,15 @@
 
 
 #include "JPSCore.h"
+
+TUniquePtr<FJPSOpenList> FJPSOpenList::Create(EJPSOpenListType InType)
+{
+	switch (InType)
+	{
+	case EJPSOpenListType::RadixHeap:
+		return MakeUnique<FJPSRadixHeap>();
+	case EJPSOpenListType::BinaryHeap:
+	default:
+		return MakeUnique<FJPSHeap>();
+	}
+}
@@ -0,0 +1,198 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "JPSCorpus.h"
+
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// 파일 앞 4바이트 "JPSC"
+static const uint32 CorpusMagic = 0x4353504A;
+
+// 이름(빈 문자열), 시드, 너비, 높이, 행 원소 수, 비트버퍼 개수, 쿼리 개수
+static const int64 MinEntrySize = 7 * sizeof(int32);
+// 시작점과 끝점
+static const int64 QuerySize = 4 * sizeof(int32);
+
+// 읽을 때 개수가 남은 바이트로 담을 수 있는 것보다 크면 할당 전에 에러로 끊는다
+static bool IsValidCount(FArchive& Ar, int32 InCount, int64 InElementSize)
+{
+	if (Ar.IsLoading() && (InCount < 0 || InCount > (Ar.TotalSize() - Ar.Tell()) / InElementSize))
+	{
+		Ar.SetError();
+		return false;
+	}
+	return true;
+}
+
+static void SerializeEntry(FArchive& Ar, FJPSCorpusEntry& InOutEntry)
+{
+	Ar << InOutEntry.Name;
+	Ar << InOutEntry.Seed;
+	Ar << InOutEntry.Map.Width;
+	Ar << InOutEntry.Map.Height;
+	Ar << InOutEntry.Map.WordWidths;
+
+	// TArray 직렬화와 같은 형식, 개수를 먼저 확인하려고 직접 쓴다
+	int32 WordCount = InOutEntry.Map.Bitmap.Num();
+	Ar << WordCount;
+	if (!IsValidCount(Ar, WordCount, sizeof(uint64)))
+	{
+		return;
+	}
+	if (Ar.IsLoading())
+	{
+		InOutEntry.Map.Bitmap.SetNumUninitialized(WordCount);
+	}
+	for (uint64& Word : InOutEntry.Map.Bitmap)
+	{
+		Ar << Word;
+	}
+
+	int32 QueryCount = InOutEntry.Queries.Num();
+	Ar << QueryCount;
+	if (!IsValidCount(Ar, QueryCount, QuerySize))
+	{
+		return;
+	}
+	if (Ar.IsLoading())
+	{
+		InOutEntry.Queries.SetNum(QueryCount);
+	}
+	for (FPathRequest& Query : InOutEntry.Queries)
+	{
+		Ar << Query.Start;
+		Ar << Query.End;
+	}
+}
+
+bool FJPSCorpus::Load(const FString& InPath)
+{
+	Entries.Reset();
+	bDirty = false;
+
+	TArray<uint8> File;
+	if (!FFileHelper::LoadFileToArray(File, *InPath, FILEREAD_Silent))
+	{
+		return false;
+	}
+
+	// 헤더는 압축하지 않는다, 매직, 버전, 압축 전 크기
+	FMemoryReader Header(File);
+	uint32 Magic = 0;
+	int32 Version = 0;
+	int32 RawSize = 0;
+	Header << Magic;
+	Header << Version;
+	Header << RawSize;
+	if (Header.IsError() || Magic != CorpusMagic || Version != VERSION || RawSize <= 0)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Ignore corpus %s (version %d, expected %d)"), *InPath, Version, VERSION);
+		return false;
+	}
+
+	const int64 Offset = Header.Tell();
+	TArray<uint8> Raw;
+	Raw.SetNumUninitialized(RawSize);
+	if (!FCompression::UncompressMemory(NAME_Zlib, Raw.GetData(), RawSize, File.GetData() + Offset, static_cast<int32>(File.Num() - Offset)))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to uncompress corpus %s"), *InPath);
+		return false;
+	}
+
+	FMemoryReader Reader(Raw);
+	int32 EntryCount = 0;
+	Reader << EntryCount;
+	if (IsValidCount(Reader, EntryCount, MinEntrySize))
+	{
+		Entries.SetNum(EntryCount);
+	}
+	for (FJPSCorpusEntry& Entry : Entries)
+	{
+		SerializeEntry(Reader, Entry);
+		if (Reader.IsError())
+		{
+			break;
+		}
+	}
+
+	// 비트버퍼 크기가 맵 크기와 맞지 않거나 맵 밖을 가리키는 쿼리가 있으면 파일 전체를 버린다
+	const bool IsValidCorpus = !Reader.IsError() && !Entries.ContainsByPredicate([](const FJPSCorpusEntry& InEntry)
+	{
+		const FJPSMovingAIMap& Map = InEntry.Map;
+		if (!Map.IsValid() || Map.WordWidths < 0 || static_cast<int64>(Map.WordWidths) * 64 < Map.Width
+			|| Map.Bitmap.Num() != static_cast<int64>(Map.WordWidths) * Map.Height)
+		{
+			return true;
+		}
+		const FIntRect Bounds(0, 0, Map.Width, Map.Height);
+		return InEntry.Queries.ContainsByPredicate([&Bounds](const FPathRequest& InQuery)
+		{
+			return !Bounds.Contains(InQuery.Start) || !Bounds.Contains(InQuery.End);
+		});
+	});
+	if (!IsValidCorpus)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Invalid corpus %s"), *InPath);
+		Entries.Reset();
+		return false;
+	}
+	return true;
+}
+
+bool FJPSCorpus::Save(const FString& InPath)
+{
+	TArray<uint8> Raw;
+	FMemoryWriter Writer(Raw);
+	int32 EntryCount = Entries.Num();
+	Writer << EntryCount;
+	for (FJPSCorpusEntry& Entry : Entries)
+	{
+		SerializeEntry(Writer, Entry);
+	}
+
+	TArray<uint8> File;
+	FMemoryWriter Header(File);
+	uint32 Magic = CorpusMagic;
+	int32 Version = VERSION;
+	int32 RawSize = Raw.Num();
+	Header << Magic;
+	Header << Version;
+	Header << RawSize;
+
+	const int32 Offset = File.Num();
+	int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, RawSize);
+	File.AddUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(NAME_Zlib, File.GetData() + Offset, CompressedSize, Raw.GetData(), RawSize))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to compress corpus %s"), *InPath);
+		return false;
+	}
+	File.SetNum(Offset + CompressedSize);
+
+	if (!FFileHelper::SaveArrayToFile(File, *InPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to write corpus %s"), *InPath);
+		return false;
+	}
+	bDirty = false;
+	return true;
+}
+
+const FJPSCorpusEntry* FJPSCorpus::Find(const FString& InName) const
+{
+	return Entries.FindByPredicate([&InName](const FJPSCorpusEntry& InEntry) { return InEntry.Name == InName; });
+}
+
+const FJPSCorpusEntry& FJPSCorpus::Add(FJPSCorpusEntry&& InEntry)
+{
+	bDirty = true;
+	if (FJPSCorpusEntry* Existing = Entries.FindByPredicate([&InEntry](const FJPSCorpusEntry& InOld) { return InOld.Name == InEntry.Name; }))
+	{
+		*Existing = MoveTemp(InEntry);
+		return *Existing;
+	}
+	return Entries.Add_GetRef(MoveTemp(InEntry));
+}
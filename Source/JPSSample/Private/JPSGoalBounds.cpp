@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "JPSGoalBounds.h"
+
+#include "Async/ParallelFor.h"
+
+#include <atomic>
+
+// 방향별 이동량, 북 북동 동 남동 남 남서 서 북서
+static const int32 DirX[FJPSGoalBounds::NDIR] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+static const int32 DirY[FJPSGoalBounds::NDIR] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+
+// 비용이 같은 경로를 모두 찾아야 하므로 실수 대신 고정소수점으로 더한다
+// 직선 2^40, 대각선 루트2 * 2^40, 256x256 맵의 가장 긴 경로에서도 반올림 오차가 서로 다른 비용의 차이보다 훨씬 작다
+static const int64 StraightCost = 1099511627776LL;
+static const int64 DiagonalCost = 1554944255988LL;
+
+struct FJPSGoalBounds::FScratch
+{
+	struct FQueued
+	{
+		int64 Cost;
+		int32 Cell;
+	};
+
+	// 비용이 작은 칸이 힙의 위로 온다
+	static bool QueuedPredicate(const FQueued& InA, const FQueued& InB)
+	{
+		return InA.Cost < InB.Cost;
+	}
+
+	TArray<int64> Costs;
+	// 시작 칸에서 이 칸까지 최적 경로들의 첫 이동 방향 비트 집합
+	TArray<uint8> FirstMoves;
+	TArray<FQueued> Open;
+};
+
+bool FJPSGoalBounds::Build(const FJPSGridView& InGrid)
+{
+	Reset();
+
+	const int32 MapWidth = InGrid.GetWidth();
+	const int32 MapHeight = InGrid.GetHeight();
+	if (MapWidth <= 0 || MapHeight <= 0 || MapWidth > MAX_int16 || MapHeight > MAX_int16 || MapWidth * MapHeight > MAX_CELLS)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Goal bounds can not be built for %d x %d map (max %d cells)"), MapWidth, MapHeight, MAX_CELLS);
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	Width = MapWidth;
+	Height = MapHeight;
+	const int32 NumCells = Width * Height;
+	Boxes.SetNum(NumCells * NDIR);
+
+	// 다익스트라가 비트배열 대신 바이트 배열을 읽도록 한번 풀어둔다
+	TArray<uint8> Open;
+	Open.SetNumUninitialized(NumCells);
+	for (int32 Y = 0; Y < Height; Y++)
+	{
+		for (int32 X = 0; X < Width; X++)
+		{
+			Open[Y * Width + X] = InGrid.IsCollision(X, Y) ? 0 : 1;
+		}
+	}
+
+	// 시작 칸마다 독립이고 비용이 맵 모양에 따라 달라서 워커가 다음 칸을 하나씩 가져간다
+	const int32 NumWorkers = FMath::Min(FTaskGraphInterface::Get().GetNumWorkerThreads() + 1, NumCells);
+	std::atomic<int32> NextSource(0);
+	ParallelFor(NumWorkers, [this, &Open, &NextSource, NumCells](int32 InWorker)
+	{
+		FScratch Scratch;
+		for (int32 Source = NextSource++; Source < NumCells; Source = NextSource++)
+		{
+			if (Open[Source])
+			{
+				BuildSource(Open, Source, Scratch);
+			}
+		}
+	});
+
+	BuildSeconds = FPlatformTime::Seconds() - StartTime;
+	UE_LOG(LogTemp, Log, TEXT("Goal bounds built for %d x %d map: %.3f s, %.2f MB"), Width, Height, BuildSeconds, GetAllocatedSize() / (1024.0 * 1024.0));
+	return true;
+}
+
+void FJPSGoalBounds::Reset()
+{
+	Boxes.Empty();
+	Width = 0;
+	Height = 0;
+	BuildSeconds = 0.0;
+}
+
+int32 FJPSGoalBounds::GetDirections(int32 InX, int32 InY, int32 InGoalX, int32 InGoalY) const
+{
+	const FJPSBoundBox* CellBoxes = &Boxes[(InY * Width + InX) * NDIR];
+	int32 Directions = 0;
+	for (int32 Dir = 0; Dir < NDIR; Dir++)
+	{
+		if (CellBoxes[Dir].Contains(InGoalX, InGoalY))
+		{
+			Directions |= 1 << Dir;
+		}
+	}
+	return Directions;
+}
+
+void FJPSGoalBounds::BuildSource(const TArray<uint8>& InOpen, int32 InSource, FScratch& InScratch)
+{
+	const int32 NumCells = Width * Height;
+	TArray<int64>& Costs = InScratch.Costs;
+	TArray<uint8>& FirstMoves = InScratch.FirstMoves;
+	TArray<FScratch::FQueued>& Open = InScratch.Open;
+	Costs.Init(MAX_int64, NumCells);
+	FirstMoves.Init(0, NumCells);
+	Open.Reset();
+
+	Costs[InSource] = 0;
+	Open.HeapPush({ 0, InSource }, FScratch::QueuedPredicate);
+
+	FJPSBoundBox* SourceBoxes = &Boxes[InSource * NDIR];
+	while (Open.Num())
+	{
+		FScratch::FQueued Current;
+		Open.HeapPop(Current, FScratch::QueuedPredicate);
+		if (Current.Cost > Costs[Current.Cell])
+		{
+			continue;
+		}
+
+		// 꺼낸 칸은 비용이 같은 앞 칸들이 모두 먼저 꺼내졌으므로 첫 이동 방향이 확정된 상태다
+		const int32 X = Current.Cell % Width;
+		const int32 Y = Current.Cell / Width;
+		if (Current.Cell != InSource)
+		{
+			for (int32 Dir = 0; Dir < NDIR; Dir++)
+			{
+				if (FirstMoves[Current.Cell] & (1 << Dir))
+				{
+					SourceBoxes[Dir].Add(X, Y);
+				}
+			}
+		}
+
+		// 모서리를 끼고 도는 대각선 이동도 허용한다, UJPSPath의 이동 규칙과 같다
+		for (int32 Dir = 0; Dir < NDIR; Dir++)
+		{
+			const int32 NextX = X + DirX[Dir];
+			const int32 NextY = Y + DirY[Dir];
+			if (NextX < 0 || NextY < 0 || NextX >= Width || NextY >= Height)
+			{
+				continue;
+			}
+			const int32 Next = NextY * Width + NextX;
+			if (!InOpen[Next])
+			{
+				continue;
+			}
+
+			const int64 NextCost = Current.Cost + ((Dir % 2) ? DiagonalCost : StraightCost);
+			const uint8 Moves = (Current.Cell == InSource) ? static_cast<uint8>(1 << Dir) : FirstMoves[Current.Cell];
+			if (NextCost < Costs[Next])
+			{
+				Costs[Next] = NextCost;
+				FirstMoves[Next] = Moves;
+				Open.HeapPush({ NextCost, Next }, FScratch::QueuedPredicate);
+			}
+			else if (NextCost == Costs[Next])
+			{
+				// 비용이 같은 최적 경로의 첫 이동도 모두 포함해야 탐색이 고른 경로를 잘라내지 않는다
+				FirstMoves[Next] |= Moves;
+			}
+		}
+	}
+}
@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "JPSGrid.h"
+
+bool FJPSGrid::Create(int32 InWidth, int32 InHeight)
+{
+	Width = InWidth;
+	Height = InHeight;
+
+	// X축 방향 2차원 비트배열 초기화
+	XBoundaryPoints.Empty();
+	XBoundaryPoints.Create(Width, Height);
+	// Y축 방향 2차원 비트배열 초기화
+	YBoundaryPoints.Empty();
+	YBoundaryPoints.Create(Height, Width);
+
+	// 비트배열의 가로 크기보다 맵의 길이가 적게 설정되기 때문에 사용하지 않는 부분을 충돌지점으로 바꾼다
+	for (int GridX = Width; GridX < XBoundaryPoints.GetBitsWidths(); GridX++)
+	{
+		for (int GridY = Height; GridY < YBoundaryPoints.GetBitsWidths(); GridY++)
+		{
+			SetAt(GridX, GridY, true);
+		}
+	}
+	return true;
+}
+
+FJPSGridView FJPSGrid::GetView() const
+{
+	FJPSGridView View;
+	View.XWords = reinterpret_cast<const uint64*>(XBoundaryPoints.GetData());
+	View.YWords = reinterpret_cast<const uint64*>(YBoundaryPoints.GetData());
+	View.XWordWidths = XBoundaryPoints.GetWordWidths();
+	View.YWordWidths = YBoundaryPoints.GetWordWidths();
+	View.Width = Width;
+	View.Height = Height;
+	return View;
+}
+
+bool FJPSGrid::SetAt(int32 InX, int32 InY, bool InFlag)
+{
+	const bool IsChanged = !IsOutBound(InX, InY) && IsCollision(InX, InY) != InFlag;
+	XBoundaryPoints.SetAt(InX, InY, InFlag);
+	YBoundaryPoints.SetAt(InY, InX, InFlag);
+	return IsChanged;
+}
+
+bool FJPSGrid::ApplyBitmap(TConstArrayView<uint64> InBitmap, int32 InWordWidths)
+{
+	// 빈 맵은 행이 없거나 마지막 원소가 없어서 쓸 곳이 없다
+	if (Width <= 0 || Height <= 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Empty Grid"));
+		return false;
+	}
+	if (InWordWidths <= 0 || InBitmap.Num() < InWordWidths * Height)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Invalid Bitmap Size"));
+		return false;
+	}
+
+	// 행 단위로 복사하고 맵 크기를 넘어선 여분 비트는 지운다
+	const int32 WordWidths = XBoundaryPoints.GetWordWidths();
+	const int32 CopyWidths = FMath::Min(WordWidths, InWordWidths);
+	const int32 LastBits = Width - (WordWidths - 1) * XBoundaryPoints.NBITMASK;
+	for (int32 GridY = 0; GridY < Height; GridY++)
+	{
+		int64* Row = XBoundaryPoints.GetData() + GridY * WordWidths;
+		FMemory::Memzero(Row, sizeof(int64) * WordWidths);
+		FMemory::Memcpy(Row, InBitmap.GetData() + GridY * InWordWidths, sizeof(int64) * CopyWidths);
+		Row[WordWidths - 1] &= FJPSBitScan::RangeMask(0, LastBits);
+	}
+
+	TransposeToYBoundary(0, 0, Width, Height);
+	return true;
+}
+
+void FJPSGrid::FillRect(int32 InX, int32 InY, int32 InWidth, int32 InHeight, bool InFlag)
+{
+	// 맵 범위로 자른다
+	const int32 MinX = FMath::Max(InX, 0);
+	const int32 MinY = FMath::Max(InY, 0);
+	const int32 MaxX = FMath::Min(InX + InWidth, Width);
+	const int32 MaxY = FMath::Min(InY + InHeight, Height);
+	if (MinX >= MaxX || MinY >= MaxY)
+	{
+		return;
+	}
+
+	// X방향 비트배열은 행의 원소에 직접 기록
+	const int32 NBitmask = XBoundaryPoints.NBITMASK;
+	const int32 WordWidths = XBoundaryPoints.GetWordWidths();
+	for (int32 GridY = MinY; GridY < MaxY; GridY++)
+	{
+		int64* Row = XBoundaryPoints.GetData() + GridY * WordWidths;
+		for (int32 Word = MinX / NBitmask; Word <= (MaxX - 1) / NBitmask; Word++)
+		{
+			const int32 WordBegin = Word * NBitmask;
+			const uint64 Mask = FJPSBitScan::RangeMask(FMath::Max(MinX - WordBegin, 0), FMath::Min(MaxX - WordBegin, NBitmask));
+			if (InFlag)
+			{
+				Row[Word] |= Mask;
+			}
+			else
+			{
+				Row[Word] &= ~Mask;
+			}
+		}
+	}
+
+	// Y방향 비트배열은 바뀐 영역을 전치해서 다시 만든다
+	TransposeToYBoundary(MinX, MinY, MaxX, MaxY);
+}
+
+void FJPSGrid::TransposeToYBoundary(int32 InMinX, int32 InMinY, int32 InMaxX, int32 InMaxY)
+{
+	const int32 NBitmask = XBoundaryPoints.NBITMASK;
+	const int32 XWordWidths = XBoundaryPoints.GetWordWidths();
+	const int32 YWordWidths = YBoundaryPoints.GetWordWidths();
+
+	uint64 Block[64];
+	for (int32 BlockY = InMinY / NBitmask; BlockY <= (InMaxY - 1) / NBitmask; BlockY++)
+	{
+		for (int32 BlockX = InMinX / NBitmask; BlockX <= (InMaxX - 1) / NBitmask; BlockX++)
+		{
+			// X방향 64행의 같은 열 원소를 모은다, 맵 밖의 행은 0
+			for (int32 Line = 0; Line < NBitmask; Line++)
+			{
+				const int32 GridY = BlockY * NBitmask + Line;
+				Block[Line] = (GridY < Height) ? static_cast<uint64>(XBoundaryPoints[GridY * XWordWidths + BlockX]) : 0ULL;
+			}
+
+			FJPSBitScan::Transpose64(Block);
+
+			// 전치된 행은 Y방향 비트배열에서 x번째 행의 원소가 된다
+			for (int32 Line = 0; Line < NBitmask; Line++)
+			{
+				const int32 GridX = BlockX * NBitmask + Line;
+				if (GridX >= Width)
+				{
+					break;
+				}
+				YBoundaryPoints[GridX * YWordWidths + BlockY] = static_cast<int64>(Block[Line]);
+			}
+		}
+	}
+}
@@ -0,0 +1,207 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "JPSGridAStar.h"
+
+void FJPSGridAStarContext::Prepare(int32 InCellCount)
+{
+	if (Visited.Num() != InCellCount)
+	{
+		Scores.SetNumUninitialized(InCellCount);
+		Parents.SetNumUninitialized(InCellCount);
+		HeapIndices.SetNumUninitialized(InCellCount);
+		Visited.SetNumZeroed(InCellCount);
+		Generation = 0;
+	}
+}
+
+void FJPSGridAStarContext::NextGeneration()
+{
+	if (++Generation == 0)
+	{
+		FMemory::Memzero(Visited.GetData(), Visited.Num() * sizeof(uint32));
+		Generation = 1;
+	}
+}
+
+SIZE_T FJPSGridAStarContext::GetAllocatedSize() const
+{
+	return Scores.GetAllocatedSize() + Parents.GetAllocatedSize() + HeapIndices.GetAllocatedSize() + Visited.GetAllocatedSize() + Heap.GetAllocatedSize();
+}
+
+namespace JPSGridAStar
+{
+	static void SetSlot(FJPSGridAStarContext& InContext, int32 InSlot)
+	{
+		InContext.HeapIndices[InContext.Heap[InSlot].Node] = InSlot;
+	}
+
+	static void ShiftUp(FJPSGridAStarContext& InContext, int32 InSlot)
+	{
+		TArray<FJPSHeapEntry>& Heap = InContext.Heap;
+		const FJPSHeapEntry Entry = Heap[InSlot];
+		while (InSlot > 0)
+		{
+			const int32 Parent = (InSlot - 1) / 2;
+			if (Entry.Total >= Heap[Parent].Total)
+			{
+				break;
+			}
+			Heap[InSlot] = Heap[Parent];
+			SetSlot(InContext, InSlot);
+			InSlot = Parent;
+		}
+		Heap[InSlot] = Entry;
+		SetSlot(InContext, InSlot);
+	}
+
+	static void ShiftDown(FJPSGridAStarContext& InContext, int32 InSlot)
+	{
+		TArray<FJPSHeapEntry>& Heap = InContext.Heap;
+		const FJPSHeapEntry Entry = Heap[InSlot];
+		const int32 HeapSize = Heap.Num();
+		while (true)
+		{
+			int32 Child = InSlot * 2 + 1;
+			if (Child >= HeapSize)
+			{
+				break;
+			}
+			if (Child + 1 < HeapSize && Heap[Child + 1].Total < Heap[Child].Total)
+			{
+				Child++;
+			}
+			if (Entry.Total <= Heap[Child].Total)
+			{
+				break;
+			}
+			Heap[InSlot] = Heap[Child];
+			SetSlot(InContext, InSlot);
+			InSlot = Child;
+		}
+		Heap[InSlot] = Entry;
+		SetSlot(InContext, InSlot);
+	}
+
+	static int32 PopMin(FJPSGridAStarContext& InContext)
+	{
+		TArray<FJPSHeapEntry>& Heap = InContext.Heap;
+		const int32 Cell = Heap[0].Node;
+		InContext.HeapIndices[Cell] = FJPSGridAStarContext::CLOSED;
+		const FJPSHeapEntry Last = Heap.Pop();
+		if (Heap.Num() > 0)
+		{
+			Heap[0] = Last;
+			ShiftDown(InContext, 0);
+		}
+		return Cell;
+	}
+}
+
+bool FJPSGridAStar::Search(FJPSGridAStarContext& InContext, FIntPoint InStartCoord, FIntPoint InEndCoord, TArray<FIntPoint>& OutResultCoord) const
+{
+	InContext.Stats.Reset();
+	OutResultCoord.Reset();
+	if (!Grid.IsValid() || Grid.IsCollision(InStartCoord.X, InStartCoord.Y) || Grid.IsCollision(InEndCoord.X, InEndCoord.Y))
+	{
+		return false;
+	}
+
+	const int32 Width = Grid.GetWidth();
+	const bool bUseMasks = Masks && Masks->GetWidth() == Width && Masks->GetHeight() == Grid.GetHeight();
+	InContext.Prepare(Width * Grid.GetHeight());
+	InContext.NextGeneration();
+	InContext.Heap.Reset();
+
+	// 방향마다 이동비용, JPS와 같은 옥타일 거리
+	float StepCosts[FJPSNeighbourMasks::NDIR];
+	for (int32 Dir = 0; Dir < FJPSNeighbourMasks::NDIR; Dir++)
+	{
+		const FIntPoint Offset = FJPSNeighbourMasks::GetOffset(Dir);
+		StepCosts[Dir] = JPSCoord(0, 0).GetOctileDistance(JPSCoord(Offset.X, Offset.Y));
+	}
+
+	const JPSCoord EndPos(InEndCoord.X, InEndCoord.Y);
+	const int32 StartCell = InStartCoord.Y * Width + InStartCoord.X;
+	const int32 EndCell = InEndCoord.Y * Width + InEndCoord.X;
+	const uint32 Generation = InContext.Generation;
+
+	InContext.Visited[StartCell] = Generation;
+	InContext.Scores[StartCell] = 0.0f;
+	InContext.Parents[StartCell] = INDEX_NONE;
+	InContext.Heap.Add({ JPSCoord(InStartCoord.X, InStartCoord.Y).GetOctileDistance(EndPos), StartCell });
+	InContext.HeapIndices[StartCell] = 0;
+	InContext.Stats.HeapPushes++;
+
+	bool bFound = false;
+	while (InContext.Heap.Num() > 0)
+	{
+		const int32 Cell = JPSGridAStar::PopMin(InContext);
+		InContext.Stats.HeapPops++;
+		if (Cell == EndCell)
+		{
+			bFound = true;
+			break;
+		}
+		InContext.Stats.Expansions++;
+
+		const int32 X = Cell % Width;
+		const int32 Y = Cell / Width;
+		const float Score = InContext.Scores[Cell];
+		uint32 Dirs = bUseMasks ? Masks->Get(X, Y) : 0xFF;
+		while (Dirs != 0)
+		{
+			const int32 Dir = static_cast<int32>(FMath::CountTrailingZeros(Dirs));
+			Dirs &= Dirs - 1;
+
+			const FIntPoint Offset = FJPSNeighbourMasks::GetOffset(Dir);
+			const int32 NextX = X + Offset.X;
+			const int32 NextY = Y + Offset.Y;
+			if (!bUseMasks && Grid.IsCollision(NextX, NextY))
+			{
+				continue;
+			}
+
+			const int32 Next = NextY * Width + NextX;
+			const float NextScore = Score + StepCosts[Dir];
+			if (InContext.Visited[Next] != Generation)
+			{
+				InContext.Visited[Next] = Generation;
+				InContext.Scores[Next] = NextScore;
+				InContext.Parents[Next] = Cell;
+				InContext.Heap.Add({ NextScore + JPSCoord(NextX, NextY).GetOctileDistance(EndPos), Next });
+				JPSGridAStar::ShiftUp(InContext, InContext.Heap.Num() - 1);
+				InContext.Stats.HeapPushes++;
+			}
+			else if (NextScore < InContext.Scores[Next] && InContext.HeapIndices[Next] != FJPSGridAStarContext::CLOSED)
+			{
+				// 휴리스틱이 일관성이 있으므로 닫힌 칸은 다시 열지 않는다
+				const int32 Slot = InContext.HeapIndices[Next];
+				InContext.Heap[Slot].Total = NextScore + JPSCoord(NextX, NextY).GetOctileDistance(EndPos);
+				InContext.Scores[Next] = NextScore;
+				InContext.Parents[Next] = Cell;
+				JPSGridAStar::ShiftUp(InContext, Slot);
+				InContext.Stats.HeapDecreaseKeys++;
+			}
+		}
+	}
+
+	if (!bFound)
+	{
+		return false;
+	}
+
+	// 경로 길이를 센 다음 목적지부터 부모를 따라가며 뒤에서부터 채운다
+	int32 Length = 0;
+	for (int32 Cell = EndCell; Cell != INDEX_NONE; Cell = InContext.Parents[Cell])
+	{
+		Length++;
+	}
+	OutResultCoord.SetNumUninitialized(Length);
+	int32 Index = Length - 1;
+	for (int32 Cell = EndCell; Cell != INDEX_NONE; Cell = InContext.Parents[Cell])
+	{
+		OutResultCoord[Index--] = FIntPoint(Cell % Width, Cell / Width);
+	}
+	return true;
+}
@@ -0,0 +1,177 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "JPSMovingAI.h"
+
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+bool FJPSMovingAI::LoadMap(const FString& InPath, FJPSMovingAIMap& OutMap)
+{
+	FString Text;
+	if (!FFileHelper::LoadFileToString(Text, *InPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to read MovingAI map %s"), *InPath);
+		return false;
+	}
+	return ParseMap(Text, OutMap);
+}
+
+bool FJPSMovingAI::ParseMap(const FString& InText, FJPSMovingAIMap& OutMap)
+{
+	OutMap = FJPSMovingAIMap();
+
+	TArray<FString> Lines;
+	InText.ParseIntoArrayLines(Lines);
+
+	// 헤더는 type, height, width 순서이고 map 줄 다음부터 격자가 시작된다
+	int32 Line = 0;
+	for (; Line < Lines.Num(); Line++)
+	{
+		const FString Header = Lines[Line].TrimStartAndEnd();
+		if (Header.Equals(TEXT("map"), ESearchCase::IgnoreCase))
+		{
+			Line++;
+			break;
+		}
+
+		FString Key;
+		FString Value;
+		if (!Header.Split(TEXT(" "), &Key, &Value))
+		{
+			continue;
+		}
+		if (Key.Equals(TEXT("type"), ESearchCase::IgnoreCase) && !Value.TrimStartAndEnd().Equals(TEXT("octile"), ESearchCase::IgnoreCase))
+		{
+			UE_LOG(LogTemp, Error, TEXT("Unsupported MovingAI map type %s"), *Value);
+			return false;
+		}
+		if (Key.Equals(TEXT("height"), ESearchCase::IgnoreCase))
+		{
+			OutMap.Height = FCString::Atoi(*Value);
+		}
+		else if (Key.Equals(TEXT("width"), ESearchCase::IgnoreCase))
+		{
+			OutMap.Width = FCString::Atoi(*Value);
+		}
+	}
+
+	if (OutMap.Width <= 0 || OutMap.Height <= 0 || Lines.Num() - Line < OutMap.Height)
+	{
+		UE_LOG(LogTemp, Error, TEXT("Invalid MovingAI map header (%d x %d, %d rows)"), OutMap.Width, OutMap.Height, Lines.Num() - Line);
+		return false;
+	}
+
+	OutMap.WordWidths = FMath::DivideAndRoundUp(OutMap.Width, 64);
+	OutMap.Bitmap.SetNumZeroed(OutMap.WordWidths * OutMap.Height);
+	for (int32 Y = 0; Y < OutMap.Height; Y++)
+	{
+		const FString& Row = Lines[Line + Y];
+		uint64* Words = &OutMap.Bitmap[Y * OutMap.WordWidths];
+		for (int32 X = 0; X < OutMap.Width; X++)
+		{
+			// 짧은 행의 나머지는 맵 밖과 같이 막는다
+			const TCHAR Cell = X < Row.Len() ? Row[X] : TEXT('@');
+			if (Cell != TEXT('.') && Cell != TEXT('G') && Cell != TEXT('S'))
+			{
+				Words[X / 64] |= 1ULL << (X % 64);
+			}
+		}
+	}
+	return true;
+}
+
+bool FJPSMovingAI::LoadScenarios(const FString& InPath, TArray<FJPSMovingAIScenario>& OutScenarios)
+{
+	FString Text;
+	if (!FFileHelper::LoadFileToString(Text, *InPath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Failed to read MovingAI scenario %s"), *InPath);
+		return false;
+	}
+	return ParseScenarios(Text, OutScenarios);
+}
+
+bool FJPSMovingAI::ParseScenarios(const FString& InText, TArray<FJPSMovingAIScenario>& OutScenarios)
+{
+	OutScenarios.Reset();
+
+	TArray<FString> Lines;
+	InText.ParseIntoArrayLines(Lines);
+
+	// 첫 줄은 version, 나머지는 bucket map width height sx sy gx gy optimal
+	TArray<FString> Fields;
+	for (const FString& Line : Lines)
+	{
+		Fields.Reset();
+		Line.ParseIntoArrayWS(Fields);
+		if (Fields.Num() == 0 || Fields[0].Equals(TEXT("version"), ESearchCase::IgnoreCase))
+		{
+			continue;
+		}
+		if (Fields.Num() < 9)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Skip invalid MovingAI scenario line: %s"), *Line);
+			continue;
+		}
+
+		FJPSMovingAIScenario& Scenario = OutScenarios.AddDefaulted_GetRef();
+		Scenario.Bucket = FCString::Atoi(*Fields[0]);
+		Scenario.MapName = Fields[1];
+		Scenario.MapWidth = FCString::Atoi(*Fields[2]);
+		Scenario.MapHeight = FCString::Atoi(*Fields[3]);
+		Scenario.Start = FIntPoint(FCString::Atoi(*Fields[4]), FCString::Atoi(*Fields[5]));
+		Scenario.Goal = FIntPoint(FCString::Atoi(*Fields[6]), FCString::Atoi(*Fields[7]));
+		Scenario.OptimalLength = FCString::Atod(*Fields[8]);
+	}
+	return OutScenarios.Num() > 0;
+}
+
+FString FJPSMovingAI::ResolveMapPath(const FString& InScenarioPath, const FJPSMovingAIScenario& InScenario)
+{
+	// 시나리오 파일에는 배포본 기준의 상대 경로(maps/dao/arena.map)가 적혀있는 경우가 많아서 파일 이름으로 찾는다
+	const FString Directory = FPaths::GetPath(InScenarioPath);
+	const FString Candidates[] = {
+		FPaths::Combine(Directory, InScenario.MapName),
+		FPaths::Combine(Directory, FPaths::GetCleanFilename(InScenario.MapName)),
+		FPaths::Combine(Directory, FPaths::GetBaseFilename(InScenarioPath)),
+	};
+	for (const FString& Candidate : Candidates)
+	{
+		if (FPaths::FileExists(Candidate))
+		{
+			return Candidate;
+		}
+	}
+	return Candidates[1];
+}
+
+double FJPSMovingAI::GetPathLength(FIntPoint InStart, TConstArrayView<FIntPoint> InPath)
+{
+	double Length = 0.0;
+	FIntPoint Prev = InStart;
+	for (const FIntPoint& Point : InPath)
+	{
+		const int32 AbsX = FMath::Abs(Point.X - Prev.X);
+		const int32 AbsY = FMath::Abs(Point.Y - Prev.Y);
+		Length += FMath::Min(AbsX, AbsY) * UE_DOUBLE_SQRT_2 + FMath::Abs(AbsX - AbsY);
+		Prev = Point;
+	}
+	return Length;
+}
+
+EJPSScenarioCheck FJPSMovingAI::CheckPath(const FJPSMovingAIScenario& InScenario, bool InFound, double InLength)
+{
+	if (!InFound)
+	{
+		return EJPSScenarioCheck::NotFound;
+	}
+
+	// 시나리오 파일의 최적값은 소수점 8자리까지 적혀있다
+	const double Tolerance = FMath::Max(1e-4, InScenario.OptimalLength * 1e-7);
+	if (InLength > InScenario.OptimalLength + Tolerance)
+	{
+		return EJPSScenarioCheck::Longer;
+	}
+	return InLength < InScenario.OptimalLength - Tolerance ? EJPSScenarioCheck::Shorter : EJPSScenarioCheck::Optimal;
+}
@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "JPSNeighbourMasks.h"
+
+bool FJPSNeighbourMasks::Build(const FJPSGridView& InGrid)
+{
+	Reset();
+	if (!InGrid.IsValid())
+	{
+		return false;
+	}
+
+	Width = InGrid.GetWidth();
+	Height = InGrid.GetHeight();
+	Masks.SetNumZeroed(Width * Height);
+
+	const int32 WordWidths = InGrid.GetWordWidths(true);
+	const int32 LastBits = Width - (WordWidths - 1) * FJPSGridView::NBITMASK;
+	// 이동 가능한 칸이 1인 원소, 맵 밖과 여분 비트는 0
+	auto OpenWord = [&InGrid, WordWidths, LastBits, this](int32 InY, int32 InWord) -> uint64
+	{
+		if (InY < 0 || InY >= Height || InWord < 0 || InWord >= WordWidths)
+		{
+			return 0;
+		}
+		const uint64 Valid = (InWord == WordWidths - 1) ? FJPSBitScan::RangeMask(0, LastBits) : ~0ULL;
+		return ~InGrid.GetRow(true, InY)[InWord] & Valid;
+	};
+
+	for (int32 GridY = 0; GridY < Height; GridY++)
+	{
+		for (int32 Word = 0; Word < WordWidths; Word++)
+		{
+			uint64 Self = OpenWord(GridY, Word);
+			if (Self == 0)
+			{
+				continue;
+			}
+
+			// 방향마다 원소 안의 비트 i가 (i + dx, y + dy) 칸의 이동 가능 여부가 되도록 이웃 행을 민다
+			uint64 Planes[NDIR];
+			for (int32 Dir = 0; Dir < NDIR; Dir++)
+			{
+				const FIntPoint Offset = GetOffset(Dir);
+				const int32 Row = GridY + Offset.Y;
+				const uint64 Center = OpenWord(Row, Word);
+				if (Offset.X > 0)
+				{
+					Planes[Dir] = (Center >> 1) | (OpenWord(Row, Word + 1) << 63);
+				}
+				else if (Offset.X < 0)
+				{
+					Planes[Dir] = (Center << 1) | (OpenWord(Row, Word - 1) >> 63);
+				}
+				else
+				{
+					Planes[Dir] = Center;
+				}
+			}
+
+			// 충돌지점은 확장되지 않으므로 이동 가능한 칸만 채운다
+			uint8* Row = Masks.GetData() + GridY * Width + Word * FJPSGridView::NBITMASK;
+			while (Self != 0)
+			{
+				const int32 Bit = FJPSBitScan::LowestBit(Self);
+				Self &= Self - 1;
+
+				uint8 Mask = 0;
+				for (int32 Dir = 0; Dir < NDIR; Dir++)
+				{
+					Mask |= static_cast<uint8>(((Planes[Dir] >> Bit) & 1) << Dir);
+				}
+				Row[Bit] = Mask;
+			}
+		}
+	}
+	return true;
+}
+
+bool FJPSNeighbourMasks::Update(const FJPSGridView& InGrid, const FIntRect& InRect)
+{
+	if (!IsValid() || InGrid.GetWidth() != Width || InGrid.GetHeight() != Height)
+	{
+		return false;
+	}
+
+	// 바뀐 칸의 이웃 칸들도 그 칸을 가리키는 비트가 바뀐다
+	const int32 MinX = FMath::Max(InRect.Min.X - 1, 0);
+	const int32 MinY = FMath::Max(InRect.Min.Y - 1, 0);
+	const int32 MaxX = FMath::Min(InRect.Max.X + 1, Width);
+	const int32 MaxY = FMath::Min(InRect.Max.Y + 1, Height);
+	for (int32 GridY = MinY; GridY < MaxY; GridY++)
+	{
+		for (int32 GridX = MinX; GridX < MaxX; GridX++)
+		{
+			uint8 Mask = 0;
+			if (!InGrid.IsCollision(GridX, GridY))
+			{
+				for (int32 Dir = 0; Dir < NDIR; Dir++)
+				{
+					const FIntPoint Offset = GetOffset(Dir);
+					Mask |= InGrid.IsCollision(GridX + Offset.X, GridY + Offset.Y) ? 0 : static_cast<uint8>(1 << Dir);
+				}
+			}
+			Masks[GridY * Width + GridX] = Mask;
+		}
+	}
+	return true;
+}
+
+void FJPSNeighbourMasks::Reset()
+{
+	Masks.Empty();
+	Width = 0;
+	Height = 0;
+}
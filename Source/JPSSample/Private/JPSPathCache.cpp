@@ -0,0 +1,234 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "JPSPathCache.h"
+#include "JPSCore.h"
+
+// InPoint에서 InRect(Max는 포함하지 않는다) 안의 가장 가까운 칸까지의 옥타일 거리
+static float GetOctileDistanceToRect(FIntPoint InPoint, const FIntRect& InRect)
+{
+	const JPSCoord Nearest(FMath::Clamp(InPoint.X, InRect.Min.X, InRect.Max.X - 1), FMath::Clamp(InPoint.Y, InRect.Min.Y, InRect.Max.Y - 1));
+	return JPSCoord(InPoint.X, InPoint.Y).GetOctileDistance(Nearest);
+}
+
+void FJPSPathCache::SetCapacity(int32 InCapacity)
+{
+	Capacity = FMath::Max(InCapacity, 0);
+	while (Lookup.Num() > Capacity)
+	{
+		Remove(Tail);
+		Stats.Evictions++;
+	}
+}
+
+bool FJPSPathCache::Find(FIntPoint InStart, FIntPoint InEnd, uint32 InVersion, TArray<FIntPoint>& OutPath)
+{
+	if (Capacity <= 0)
+	{
+		return false;
+	}
+
+	bool bReversed = false;
+	const int32* Found = Lookup.Find(MakeKey(InStart, InEnd, bReversed));
+	if (!Found)
+	{
+		Stats.Misses++;
+		return false;
+	}
+
+	const int32 Index = *Found;
+	if (Entries[Index].Version != InVersion)
+	{
+		// Invalidate 없이 맵이 바뀌었다
+		Remove(Index);
+		Stats.Invalidations++;
+		Stats.Misses++;
+		return false;
+	}
+
+	// 가장 최근에 쓴 원소로 옮긴다
+	Unlink(Index);
+	Link(Index);
+	Stats.Hits++;
+
+	const TArray<FIntPoint>& Path = Entries[Index].Path;
+	OutPath.Reset(Path.Num());
+	if (bReversed)
+	{
+		for (int32 Point = Path.Num() - 1; Point >= 0; Point--)
+		{
+			OutPath.Add(Path[Point]);
+		}
+	}
+	else
+	{
+		OutPath.Append(Path);
+	}
+	return true;
+}
+
+void FJPSPathCache::Add(FIntPoint InStart, FIntPoint InEnd, uint32 InVersion, TConstArrayView<FIntPoint> InPath)
+{
+	if (Capacity <= 0 || InPath.Num() == 0)
+	{
+		return;
+	}
+
+	bool bReversed = false;
+	const FKey Key = MakeKey(InStart, InEnd, bReversed);
+	if (const int32* Found = Lookup.Find(Key))
+	{
+		Remove(*Found);
+	}
+	if (Lookup.Num() >= Capacity)
+	{
+		Remove(Tail);
+		Stats.Evictions++;
+	}
+
+	const int32 Index = FreeEntries.Num() > 0 ? FreeEntries.Pop() : Entries.AddDefaulted();
+	FEntry& Entry = Entries[Index];
+	Entry.Key = Key;
+	Entry.Version = InVersion;
+	Entry.Path.Reset(InPath.Num());
+	Entry.Cost = 0.0f;
+	Entry.Bounds = FIntRect(InPath[0], InPath[0] + FIntPoint(1, 1));
+	for (int32 Point = 0; Point < InPath.Num(); Point++)
+	{
+		// 키의 A부터 시작하도록 저장한다
+		const FIntPoint& Coord = InPath[bReversed ? InPath.Num() - 1 - Point : Point];
+		if (Point > 0)
+		{
+			const FIntPoint& Prev = Entry.Path.Last();
+			Entry.Cost += JPSCoord(Prev.X, Prev.Y).GetOctileDistance(JPSCoord(Coord.X, Coord.Y));
+		}
+		Entry.Path.Add(Coord);
+		Entry.Bounds.Min = Entry.Bounds.Min.ComponentMin(Coord);
+		Entry.Bounds.Max = Entry.Bounds.Max.ComponentMax(Coord + FIntPoint(1, 1));
+	}
+
+	Lookup.Add(Key, Index);
+	Link(Index);
+}
+
+void FJPSPathCache::Invalidate(const FIntRect& InRect, bool InBlocked, uint32 InNewVersion)
+{
+	for (int32 Index = Head; Index != INDEX_NONE;)
+	{
+		FEntry& Entry = Entries[Index];
+		const int32 Next = Entry.Next;
+
+		bool bStale = false;
+		if (InBlocked)
+		{
+			// 막힌 칸을 지나지 않는 경로는 여전히 이동 가능하고, 선택지가 줄었을 뿐이라 최단 경로로 남는다
+			bStale = Entry.Bounds.Intersect(InRect) && Crosses(Entry, InRect);
+		}
+		else
+		{
+			// 열린 칸을 거치는 어떤 경로도 이 하한보다 짧을 수 없으므로 하한이 현재 비용보다 작은 경로만 버린다
+			const float LowerBound = GetOctileDistanceToRect(Entry.Key.A, InRect) + GetOctileDistanceToRect(Entry.Key.B, InRect);
+			bStale = LowerBound < Entry.Cost - KINDA_SMALL_NUMBER;
+		}
+
+		if (bStale)
+		{
+			Remove(Index);
+			Stats.Invalidations++;
+		}
+		else
+		{
+			Entry.Version = InNewVersion;
+		}
+		Index = Next;
+	}
+}
+
+void FJPSPathCache::Reset()
+{
+	Stats.Invalidations += Lookup.Num();
+	Entries.Reset();
+	FreeEntries.Reset();
+	Lookup.Reset();
+	Head = INDEX_NONE;
+	Tail = INDEX_NONE;
+}
+
+FJPSPathCache::FKey FJPSPathCache::MakeKey(FIntPoint InStart, FIntPoint InEnd, bool& OutReversed)
+{
+	OutReversed = InEnd.Y < InStart.Y || (InEnd.Y == InStart.Y && InEnd.X < InStart.X);
+	return OutReversed ? FKey{ InEnd, InStart } : FKey{ InStart, InEnd };
+}
+
+bool FJPSPathCache::Crosses(const FEntry& InEntry, const FIntRect& InRect)
+{
+	// 점 사이는 직선이나 대각선이므로 한 칸씩 따라간다
+	const TArray<FIntPoint>& Path = InEntry.Path;
+	for (int32 Point = 0; Point < Path.Num(); Point++)
+	{
+		FIntPoint Coord = Path[Point];
+		const FIntPoint To = Path[FMath::Min(Point + 1, Path.Num() - 1)];
+		const FIntPoint Step(FMath::Sign(To.X - Coord.X), FMath::Sign(To.Y - Coord.Y));
+		while (true)
+		{
+			if (InRect.Contains(Coord))
+			{
+				return true;
+			}
+			if (Coord == To)
+			{
+				break;
+			}
+			Coord = Coord + Step;
+		}
+	}
+	return false;
+}
+
+void FJPSPathCache::Link(int32 InIndex)
+{
+	FEntry& Entry = Entries[InIndex];
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = Head;
+	if (Head != INDEX_NONE)
+	{
+		Entries[Head].Prev = InIndex;
+	}
+	Head = InIndex;
+	if (Tail == INDEX_NONE)
+	{
+		Tail = InIndex;
+	}
+}
+
+void FJPSPathCache::Unlink(int32 InIndex)
+{
+	FEntry& Entry = Entries[InIndex];
+	if (Entry.Prev != INDEX_NONE)
+	{
+		Entries[Entry.Prev].Next = Entry.Next;
+	}
+	else
+	{
+		Head = Entry.Next;
+	}
+	if (Entry.Next != INDEX_NONE)
+	{
+		Entries[Entry.Next].Prev = Entry.Prev;
+	}
+	else
+	{
+		Tail = Entry.Prev;
+	}
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = INDEX_NONE;
+}
+
+void FJPSPathCache::Remove(int32 InIndex)
+{
+	Unlink(InIndex);
+	FEntry& Entry = Entries[InIndex];
+	Lookup.Remove(Entry.Key);
+	Entry.Path.Reset();
+	FreeEntries.Add(InIndex);
+}
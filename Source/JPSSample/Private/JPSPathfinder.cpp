@@ -0,0 +1,822 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "JPSPathfinder.h"
+
+#include "Async/ParallelFor.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+#include <atomic>
+
+// stat JPS, 프레임마다 끝난 탐색들의 작업량 합
+DECLARE_STATS_GROUP(TEXT("JPS"), STATGROUP_JPS, STATCAT_Advanced);
+DECLARE_CYCLE_STAT(TEXT("Search"), STAT_JPSSearch, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Searches"), STAT_JPSSearches, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Nodes Expanded"), STAT_JPSExpansions, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Jump Points"), STAT_JPSJumpPoints, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Straight Jumps"), STAT_JPSStraightJumps, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Diagonal Jumps"), STAT_JPSDiagonalJumps, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Scans"), STAT_JPSScans, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Words Touched"), STAT_JPSWordsTouched, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Heap Pushes"), STAT_JPSHeapPushes, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Heap Pops"), STAT_JPSHeapPops, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Heap Decrease Keys"), STAT_JPSHeapDecreaseKeys, STATGROUP_JPS);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Closed Words Cleared"), STAT_JPSClosedWordsCleared, STATGROUP_JPS);
+
+// csv.Category JPS, 같은 값을 CSV 프로파일러 캡처에 프레임 단위로 남긴다
+CSV_DEFINE_CATEGORY(JPS, true);
+
+// 끝난 탐색 하나의 작업량을 stat과 CSV에 더한다, 워커 스레드에서도 호출된다
+static void PublishSearchStats(const FJPSSearchStats& InStats)
+{
+	INC_DWORD_STAT(STAT_JPSSearches);
+	INC_DWORD_STAT_BY(STAT_JPSExpansions, InStats.Expansions);
+	INC_DWORD_STAT_BY(STAT_JPSJumpPoints, InStats.JumpPoints);
+	INC_DWORD_STAT_BY(STAT_JPSStraightJumps, InStats.StraightJumps);
+	INC_DWORD_STAT_BY(STAT_JPSDiagonalJumps, InStats.DiagonalJumps);
+	INC_DWORD_STAT_BY(STAT_JPSScans, InStats.Scans);
+	INC_DWORD_STAT_BY(STAT_JPSWordsTouched, InStats.WordsTouched);
+	INC_DWORD_STAT_BY(STAT_JPSHeapPushes, InStats.HeapPushes);
+	INC_DWORD_STAT_BY(STAT_JPSHeapPops, InStats.HeapPops);
+	INC_DWORD_STAT_BY(STAT_JPSHeapDecreaseKeys, InStats.HeapDecreaseKeys);
+	INC_DWORD_STAT_BY(STAT_JPSClosedWordsCleared, InStats.ClosedWordsCleared);
+
+	CSV_CUSTOM_STAT(JPS, Searches, 1, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(JPS, Expansions, InStats.Expansions, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(JPS, JumpPoints, InStats.JumpPoints, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(JPS, StraightJumps, InStats.StraightJumps, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(JPS, DiagonalJumps, InStats.DiagonalJumps, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(JPS, Scans, InStats.Scans, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(JPS, WordsTouched, static_cast<int32>(InStats.WordsTouched), ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(JPS, HeapPushes, InStats.HeapPushes, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(JPS, HeapPops, InStats.HeapPops, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(JPS, HeapDecreaseKeys, InStats.HeapDecreaseKeys, ECsvCustomStatOp::Accumulate);
+	CSV_CUSTOM_STAT(JPS, ClosedWordsCleared, InStats.ClosedWordsCleared, ECsvCustomStatOp::Accumulate);
+}
+
+void FJPSSearchContext::Prepare(int32 InWidth, int32 InHeight, EJPSOpenListType InType)
+{
+	if (!OpenList.IsValid() || OpenList->GetType() != InType)
+	{
+		OpenList = FJPSOpenList::Create(InType);
+	}
+
+	if (ClosedList.GetWidth() != InWidth || ClosedList.GetHeight() != InHeight)
+	{
+		ClosedList.Create(InWidth, InHeight);
+	}
+}
+
+SIZE_T FJPSSearchContext::GetAllocatedSize() const
+{
+	return (OpenList.IsValid() ? OpenList->GetAllocatedSize() : 0) + ClosedList.GetAllocatedSize() + Nodes.GetAllocatedSize() + PathResults.GetAllocatedSize();
+}
+
+void FJPSPathfinder::SetMap(const FJPSGridView& InGrid)
+{
+	Grid = InGrid;
+	GridWidth = Grid.GetWidth();
+	GridHeight = Grid.GetHeight();
+	if (Grid.IsValid())
+	{
+		GameThreadContext.Prepare(GridWidth, GridHeight, OpenListType);
+	}
+}
+
+void FJPSPathfinder::SetOpenListType(EJPSOpenListType InType)
+{
+	// 컨텍스트들은 다음 탐색에서 바뀐 구현으로 오픈리스트를 새로 만든다
+	OpenListType = InType;
+}
+
+bool FJPSPathfinder::BuildJumpTable()
+{
+	if (!Grid.IsValid())
+	{
+		return false;
+	}
+	return JumpTable.Build(Grid);
+}
+
+bool FJPSPathfinder::RepairJumpTable(int32 InX, int32 InY)
+{
+	if (!Grid.IsValid() || !JumpTable.Repair(Grid, InX, InY))
+	{
+		JumpTable.Reset();
+		return false;
+	}
+	return true;
+}
+
+bool FJPSPathfinder::BuildGoalBounds()
+{
+	if (!Grid.IsValid())
+	{
+		return false;
+	}
+	return GoalBounds.Build(Grid);
+}
+
+void FJPSPathfinder::DestroyMap()
+{
+	JumpTable.Reset();
+	GoalBounds.Reset();
+	Grid = FJPSGridView();
+	GridWidth = 0;
+	GridHeight = 0;
+	GameThreadContext = FJPSSearchContext();
+	BatchContexts.Reset();
+	// 빌려준 컨텍스트는 돌려받을 때 다시 등록되기 때문에 빌려주지 않은 컨텍스트만 정리한다
+	for (FJPSSearchContext* Context : FreeAsyncContexts)
+	{
+		AsyncContexts.RemoveAll([Context](const TUniquePtr<FJPSSearchContext>& InOwned) { return InOwned.Get() == Context; });
+	}
+	FreeAsyncContexts.Reset();
+}
+
+bool FJPSPathfinder::Search(FIntPoint InStartCoord, FIntPoint InEndCoord, TArray<FIntPoint>& OutResultCoord)
+{
+	if (!Grid.IsValid())
+	{
+		return false;
+	}
+
+	return Search(GameThreadContext, InStartCoord, InEndCoord, OutResultCoord);
+}
+
+void FJPSPathfinder::FindPathBatch(TConstArrayView<FPathRequest> InRequests, TArrayView<FPathResult> OutResults)
+{
+	check(OutResults.Num() >= InRequests.Num());
+	if (InRequests.Num() == 0)
+	{
+		return;
+	}
+
+	if (!Grid.IsValid())
+	{
+		for (int32 Index = 0; Index < InRequests.Num(); Index++)
+		{
+			OutResults[Index].bFound = false;
+			OutResults[Index].Path.Reset();
+		}
+		return;
+	}
+
+	TRACE_CPUPROFILER_EVENT_SCOPE(FJPSPathfinder::FindPathBatch);
+
+	// 워커 수만큼 컨텍스트를 준비한다, 요청이 적으면 그만큼만 쓴다
+	const int32 NumWorkers = FMath::Min(FTaskGraphInterface::Get().GetNumWorkerThreads() + 1, InRequests.Num());
+	while (BatchContexts.Num() < NumWorkers)
+	{
+		BatchContexts.Add(MakeUnique<FJPSSearchContext>());
+	}
+
+	// 탐색 비용이 요청마다 크게 달라서 미리 나누지 않고 워커가 다음 요청을 하나씩 가져간다
+	std::atomic<int32> NextRequest(0);
+	ParallelFor(NumWorkers, [this, &InRequests, &OutResults, &NextRequest](int32 InWorker)
+	{
+		FJPSSearchContext& Context = *BatchContexts[InWorker];
+		for (int32 Index = NextRequest++; Index < InRequests.Num(); Index = NextRequest++)
+		{
+			FPathResult& Result = OutResults[Index];
+			Result.bFound = Search(Context, InRequests[Index].Start, InRequests[Index].End, Result.Path);
+		}
+	});
+}
+
+FJPSSearchContext* FJPSPathfinder::AcquireContext()
+{
+	if (FreeAsyncContexts.Num() == 0)
+	{
+		FreeAsyncContexts.Add(AsyncContexts.Add_GetRef(MakeUnique<FJPSSearchContext>()).Get());
+	}
+	return FreeAsyncContexts.Pop();
+}
+
+void FJPSPathfinder::ReleaseContext(FJPSSearchContext* InContext)
+{
+	if (InContext)
+	{
+		FreeAsyncContexts.Add(InContext);
+	}
+}
+
+bool FJPSPathfinder::Search(FJPSSearchContext& InContext, FIntPoint InStartCoord, FIntPoint InEndCoord, TArray<FIntPoint>& OutResultCoord) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_JPSSearch);
+
+	if (!BeginSearch(InContext, InStartCoord, InEndCoord))
+	{
+		return false;
+	}
+
+	// 예산 없이 끝까지 탐색
+	return StepSearch(InContext, FJPSSearchBudget(), OutResultCoord) == EJPSSearchStatus::Found;
+}
+
+bool FJPSPathfinder::BeginSearch(FJPSSearchContext& InContext, FIntPoint InStartCoord, FIntPoint InEndCoord) const
+{
+	InContext.Status = EJPSSearchStatus::Failed;
+	if (!Grid.IsValid())
+	{
+		return false;
+	}
+
+	//범위 체크
+	if ((InStartCoord.X < 0 || InStartCoord.X >= GridWidth) ||
+		(InStartCoord.Y < 0 || InStartCoord.Y >= GridHeight) ||
+		(InEndCoord.X < 0 || InEndCoord.X >= GridWidth) ||
+		(InEndCoord.Y < 0 || InEndCoord.Y >= GridHeight) ||
+		(InStartCoord.X == InEndCoord.X && InStartCoord.Y == InEndCoord.Y))
+	{
+		return false;
+	}
+
+	// 버퍼 준비와 이전 탐색의 흔적 정리
+	TRACE_CPUPROFILER_EVENT_SCOPE(FJPSPathfinder::BeginSearch);
+
+	InContext.Prepare(GridWidth, GridHeight, OpenListType);
+
+	FJPSOpenList& OpenList = *InContext.OpenList;
+	FJPSNodeArena& Nodes = InContext.Nodes;
+
+	InContext.PathResults.Reset();
+	InContext.EndPos.X = InEndCoord.X;
+	InContext.EndPos.Y = InEndCoord.Y;
+	OpenList.ClearHeap();
+	OpenList.SetArena(&Nodes);
+	InContext.Stats.Reset();
+	InContext.Stats.ClosedWordsCleared = InContext.ClosedList.GetTouchedCount();
+	InContext.ClosedList.ClearTouched();
+	Nodes.Reset();
+
+	// 시작위치 노드 세팅 방향은 전방향
+	int32 StartNode = Nodes.Add(INDEX_NONE, JPSCoord(InStartCoord.X, InStartCoord.Y), InContext.EndPos, 8);
+
+	// 시작 노드를 오픈
+	OpenList.Insert(StartNode);
+	InContext.Stats.HeapPushes++;
+	// 탐색완료된 노드에 시작 노드를 추가
+	InContext.ClosedList.SetAt(InStartCoord.X, InStartCoord.Y, true);
+
+	InContext.BestNode = StartNode;
+	InContext.Status = EJPSSearchStatus::InProgress;
+	return true;
+}
+
+EJPSSearchStatus FJPSPathfinder::StepSearch(FJPSSearchContext& InContext, const FJPSSearchBudget& InBudget, TArray<FIntPoint>& OutResultCoord, bool InPartialPath) const
+{
+	OutResultCoord.Reset();
+	if (!Grid.IsValid() || InContext.Status != EJPSSearchStatus::InProgress)
+	{
+		return InContext.Status;
+	}
+
+	// 노드 확장과 점프포인트 검색
+	TRACE_CPUPROFILER_EVENT_SCOPE(FJPSPathfinder::StepSearch);
+
+	FJPSOpenList& OpenList = *InContext.OpenList;
+	TDTrackedBitArray<int64>& ClosedList = InContext.ClosedList;
+	FJPSNodeArena& Nodes = InContext.Nodes;
+	const JPSCoord& EndPos = InContext.EndPos;
+	FJPSSearchStats& Stats = InContext.Stats;
+	// 이 단계에서 맵을 검색한 횟수와 읽은 원소는 Stats에 기록된다
+	FJPSSearchStatsScope StatsScope(Stats);
+
+	const bool UseJumpTable = JumpTable.IsValid();
+	const bool UseGoalBounds = GoalBounds.IsValid();
+	const bool HasTimeBudget = InBudget.MaxMicroseconds > 0.0;
+	const double EndTime = HasTimeBudget ? FPlatformTime::Seconds() + InBudget.MaxMicroseconds * 1e-6 : 0.0;
+	int32 Expansions = 0;
+
+	while (OpenList.GetCount())
+	{
+		// 예산은 노드를 꺼내기 전에 확인해서 꺼낸 노드는 항상 끝까지 확장한다
+		if ((InBudget.MaxExpansions > 0 && Expansions >= InBudget.MaxExpansions) ||
+			(HasTimeBudget && Expansions > 0 && FPlatformTime::Seconds() >= EndTime))
+		{
+			if (InPartialPath)
+			{
+				// 목적지에 가장 가까워 보이는 노드까지의 경로
+				TracePath(InContext, InContext.BestNode, false, OutResultCoord);
+			}
+			return EJPSSearchStatus::InProgress;
+		}
+		Expansions++;
+		Stats.Expansions++;
+
+		// 오픈리스트에서 가장 우선순위가 높은 노드 검사 시작
+		int32 CurrNode = OpenList.PopMin();
+		Stats.HeapPops++;
+		// 노드 추가로 아레나가 재할당될 수 있기 때문에 필요한 값은 복사해둔다
+		const JPSCoord CurrPos = Nodes[CurrNode].Pos;
+		const char CurrDir = Nodes[CurrNode].CardinalDir;
+		// 강제이웃과 자연이웃의 방향을 추가
+		int32 Directions = GetForcedNeighbours(CurrPos, CurrDir) | GetNaturalNeighbours(CurrDir);
+		// 이 칸에서 목적지로 가는 최적 경로가 시작할 수 없는 방향은 뺀다
+		if (UseGoalBounds)
+		{
+			Directions &= GoalBounds.GetDirections(CurrPos.X, CurrPos.Y, EndPos.X, EndPos.Y);
+		}
+
+		for (int32 Dir = 0; Dir < 8; Dir++)
+		{
+			// 필요한 방향 검사
+			if ((1 << Dir) & Directions)
+			{
+				// 해당 방향으로 점프포인트 탐색
+				if (DirIsDiagonal(Dir))
+				{
+					Stats.DiagonalJumps++;
+				}
+				else
+				{
+					Stats.StraightJumps++;
+				}
+				JPSCoord JumpPoint = UseJumpTable ? JumpWithTable(CurrPos, Dir, EndPos) : Jump(CurrPos, Dir, EndPos);
+				// 점프포인트가 존재한다면
+				if (!JumpPoint.IsEmpty())
+				{
+					// 도착
+					if (JumpPoint == EndPos)
+					{
+						TracePath(InContext, CurrNode, true, OutResultCoord);
+						InContext.Status = EJPSSearchStatus::Found;
+						PublishSearchStats(Stats);
+						return EJPSSearchStatus::Found;
+					}
+
+					// 점프포인트 노드를 생성
+					int32 NewNode = Nodes.Add(CurrNode, JumpPoint, EndPos, Dir);
+					Stats.JumpPoints++;
+					if (Nodes[NewNode].Heuri < Nodes[InContext.BestNode].Heuri)
+					{
+						InContext.BestNode = NewNode;
+					}
+
+					// 처음 탐색된 좌표라면 힙에 새로 등록
+					if (!ClosedList.IsSet(JumpPoint.X, JumpPoint.Y))
+					{
+						// 힙에 새로운 원소를 등록
+						OpenList.Insert(NewNode);
+						Stats.HeapPushes++;
+						// 탐색된 좌표로 등록
+						ClosedList.SetAt(JumpPoint.X, JumpPoint.Y, true);
+					}
+					else
+					{
+						// 이미 탐색된 좌표라면 우선순위를 갱신
+						if (OpenList.InsertSmaller(NewNode))
+						{
+							Stats.HeapDecreaseKeys++;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("JPS Pathfind Failed."));
+	InContext.Status = EJPSSearchStatus::Failed;
+	PublishSearchStats(Stats);
+	return EJPSSearchStatus::Failed;
+}
+
+void FJPSPathfinder::TracePath(FJPSSearchContext& InContext, int32 InNode, bool InReachedEnd, TArray<FIntPoint>& OutResultCoord) const
+{
+	TRACE_CPUPROFILER_EVENT_SCOPE(FJPSPathfinder::TracePath);
+
+	const FJPSNodeArena& Nodes = InContext.Nodes;
+	TArray<JPSCoord>& PathResults = InContext.PathResults;
+	PathResults.Reset();
+
+	// 도착했다면 목적지를 마지막 점으로 두고, 아니라면 InNode가 마지막 점이 되도록 어떤 방향과도 다른 값으로 시작한다
+	int32 CurDir = -1;
+	if (InReachedEnd)
+	{
+		PathResults.Insert(InContext.EndPos, 0);
+		CurDir = GetCoordinateDir(InContext.EndPos, Nodes[InNode].Pos);
+	}
+
+	// 현재 노드를 기준으로 역순으로 따라가면서 점프포인트 목록을 구성
+	int32 TraceNode = InNode;
+	while (TraceNode != INDEX_NONE)
+	{
+		const FJPSNode& Trace = Nodes[TraceNode];
+		int32 NextDir = 0;
+		// 부모가 있다면 현재노드->부모 방향의 좌표를 구함
+		if (Trace.Parent != INDEX_NONE)
+		{
+			NextDir = GetCoordinateDir(Trace.Pos, Nodes[Trace.Parent].Pos);
+		}
+		// 현재 진행 방향과 새로 구한 방향이 다르다면 목록에 추가
+		if (CurDir != NextDir)
+		{
+			PathResults.Insert(Trace.Pos, 0);
+		}
+		// 다음 부모로 변경
+		TraceNode = Trace.Parent;
+		// 방향 갱신
+		CurDir = NextDir;
+	}
+
+	// 경로 단순화
+	//PullingString(PathResults);
+	// 3D좌표화
+	for (int32 Node = 0; Node < PathResults.Num(); Node++)
+	{
+		OutResultCoord.Add(FIntPoint(PathResults[Node].X, PathResults[Node].Y));
+	}
+}
+
+JPSCoord FJPSPathfinder::NextCoordinate(const JPSCoord& InCoord, const int32 InDir) const
+{
+	// 북 북동 동 남동 남 남서 서 북서 정지
+	static const int32 dirMov[] = { 0,-1,1,-1,1,0,1,1,0,1,-1,1,-1,0,-1,-1,0,0 };
+	return JPSCoord(InCoord.X + dirMov[InDir * 2], InCoord.Y + dirMov[InDir * 2 + 1]);
+}
+
+int32 FJPSPathfinder::GetCoordinateDir(const JPSCoord& InSCoord, const JPSCoord& InDirCoord) const
+{
+	int32 Dirs = 0;
+	// 서쪽
+	if (InSCoord.X > InDirCoord.X)
+	{
+		Dirs += 1 << 4;
+	}
+	// 동쪽
+	else if (InSCoord.X < InDirCoord.X)
+	{
+		Dirs += 1 << 2;
+	}
+	// 북쪽
+	if (InSCoord.Y > InDirCoord.Y)
+	{
+		Dirs += 1 << 3;
+	}
+	// 남쪽
+	else if (InSCoord.Y < InDirCoord.Y)
+	{
+		Dirs += 1 << 1;
+	}
+	return Dirs;
+}
+
+int32 FJPSPathfinder::GetForcedNeighbours(const JPSCoord& InCoord, const int32 InDir) const
+{
+	//	7	0	1
+	//	6		2
+	//	5	4	3
+	if (InDir > 7)
+	{
+		return 0;
+	}
+
+	int32 Dirs = 0;
+#define ENTERABLE(n) IsPassable ( NextCoordinate (InCoord, (InDir + (n)) % 8))
+
+	// 대각선인경우
+	if (DirIsDiagonal(InDir))
+	{
+		// ex) Dir == 3 // ENT(1), ENT(0)
+		if (!Implies(ENTERABLE(6), ENTERABLE(5)))
+			Dirs = AddDirectionToSet(Dirs, (InDir + 6) % 8);
+		// ex) Dir == 3 // ENT(5), ENT(6)
+		if (!Implies(ENTERABLE(2), ENTERABLE(3)))
+			Dirs = AddDirectionToSet(Dirs, (InDir + 2) % 8);
+	}
+	else
+	{
+		// ex) Dir == 2 // ENT(1), ENT(0)
+		if (!Implies(ENTERABLE(7), ENTERABLE(6)))
+			Dirs = AddDirectionToSet(Dirs, (InDir + 7) % 8);
+		// ex) Dir == 2 // ENT(3), ENT(4)
+		if (!Implies(ENTERABLE(1), ENTERABLE(2)))
+			Dirs = AddDirectionToSet(Dirs, (InDir + 1) % 8);
+	}
+
+#undef ENTERABLE	
+
+	return Dirs;
+}
+
+
+int32 FJPSPathfinder::GetNaturalNeighbours(const int32 InDir) const
+{
+	if (InDir == NODIRECTION)
+		return 255;
+
+	int32 Dirs = 0;
+	// 현재 방향 추가
+	Dirs = AddDirectionToSet(Dirs, InDir);
+	// 현재 방향이 대각선이면 해당 방향의 수직 방향도 추가
+	if (DirIsDiagonal(InDir))
+	{
+		Dirs = AddDirectionToSet(Dirs, (InDir + 1) % 8);
+		Dirs = AddDirectionToSet(Dirs, (InDir + 7) % 8);
+	}
+	return Dirs;
+}
+
+JPSCoord FJPSPathfinder::Jump(const JPSCoord& InCoord, const char InDir, const JPSCoord& InEndPos) const
+{
+	// 대각선은 행과 열 창을 이어가며 한 구간씩 검사한다
+	switch (InDir)
+	{
+	case 1:
+		return JumpDiagonal<1, -1>(InCoord, InEndPos);
+	case 3:
+		return JumpDiagonal<1, 1>(InCoord, InEndPos);
+	case 5:
+		return JumpDiagonal<-1, 1>(InCoord, InEndPos);
+	case 7:
+		return JumpDiagonal<-1, -1>(InCoord, InEndPos);
+	}
+
+	// 다음 좌표
+	const JPSCoord NextCoord = NextCoordinate(InCoord, InDir);
+	if (!IsPassable(NextCoord))
+	{
+		return JPSCoord(-1, -1);
+	}
+	// 다음 좌표에 강제이웃이 있으거나 목적지라면 점프포인트로 지정
+	if (GetForcedNeighbours(NextCoord, InDir) || InEndPos == NextCoord)
+	{
+		return NextCoord;
+	}
+	// 직선검사라면 해당 방향으로 쭉 검사 점프포인트가 있다면 해당 지점 반환
+	return StraightJumpPoint(NextCoord, InDir, InEndPos);
+}
+
+// LoadWindow로 읽은 64칸 창을 진행방향 순서로 다룬다, 창의 i번 칸은 시작 칸에서 진행방향으로 i칸 떨어진 곳
+template <bool IsForward>
+struct TJPSWindow
+{
+	static bool Test(uint64 InWindow, int32 InIndex) { return (InWindow >> (IsForward ? InIndex : 63 - InIndex)) & 1; }
+	// i번 칸에 i + 1번 칸을 놓는다, 마지막 칸은 비어서 열린 칸이 된다
+	static uint64 Advance(uint64 InWindow) { return IsForward ? InWindow >> 1 : InWindow << 1; }
+	// [InBegin, InEnd) 칸
+	static uint64 Range(int32 InBegin, int32 InEnd) { return IsForward ? FJPSBitScan::RangeMask(InBegin, InEnd) : FJPSBitScan::RangeMask(64 - InEnd, 64 - InBegin); }
+	static uint64 Cell(int32 InIndex) { return IsForward ? 1ULL << InIndex : 1ULL << (63 - InIndex); }
+	// 가장 앞쪽 칸 (InWindow != 0)
+	static int32 First(uint64 InWindow) { return IsForward ? FJPSBitScan::LowestBit(InWindow) : 63 - FJPSBitScan::HighestBit(InWindow); }
+};
+
+template <int32 InDirX, int32 InDirY>
+JPSCoord FJPSPathfinder::JumpDiagonal(const JPSCoord& InCoord, const JPSCoord& InEndPos) const
+{
+	using FRowWindow = TJPSWindow<(InDirX > 0)>;
+	using FColumnWindow = TJPSWindow<(InDirY > 0)>;
+	constexpr int32 RowDir = InDirX > 0 ? 2 : 6;
+	constexpr int32 ColumnDir = InDirY > 0 ? 4 : 0;
+	// 직선 검사는 창의 2번 칸(다음 칸)부터 보고, 옆 행은 다음 칸을 같이 봐야 하므로 세 번 밀린 창에서도 남아있는 칸까지만 본다
+	constexpr int32 ScanBegin = 2;
+	constexpr int32 ScanEnd = 61;
+
+	// 칸 (X, Y)에서 행 창은 X - InDirX, 열 창은 Y - InDirY에서 시작한다, 창의 1번 칸이 현재 칸
+	// 행 창은 현재 행과 지나온 행(Behind), 다음 행(Ahead), 열 창은 현재 열과 지나온 열, 다음 열
+	// 한 칸 진행하면 현재와 다음 창을 한 칸 밀어서 지나온 창과 현재 창으로 쓰고 새 창 하나씩만 읽는다
+	int32 X = InCoord.X + InDirX;
+	int32 Y = InCoord.Y + InDirY;
+	uint64 RowBehind = Grid.LoadWindow<true, (InDirX > 0)>(Y - InDirY, X - InDirX);
+	uint64 Row = Grid.LoadWindow<true, (InDirX > 0)>(Y, X - InDirX);
+	uint64 RowAhead = Grid.LoadWindow<true, (InDirX > 0)>(Y + InDirY, X - InDirX);
+	JPS_SEARCH_STAT_ADD(WordsTouched, 6);
+	// 대부분의 대각선 점프는 첫 칸의 행 검사에서 끝나기 때문에 열 창은 처음 필요할 때 읽는다
+	bool HasColumns = false;
+	uint64 ColumnBehind = 0;
+	uint64 Column = 0;
+	uint64 ColumnAhead = 0;
+
+	while (true)
+	{
+		// 막힌 칸이면 점프포인트가 없다, 맵 밖도 창에서 충돌지점으로 읽힌다
+		if (FRowWindow::Test(Row, 1))
+		{
+			return JPSCoord(-1, -1);
+		}
+		const JPSCoord Coord(X, Y);
+		// 강제이웃, 지나온 방향의 옆 칸이 막혀있고 그 대각선 칸이 열려있으면 생긴다
+		// (-InDirX, 0)과 (-InDirX, InDirY), (0, -InDirY)와 (InDirX, -InDirY)
+		const bool IsForced = (FRowWindow::Test(Row, 0) && !FRowWindow::Test(RowAhead, 0))
+			|| (FRowWindow::Test(RowBehind, 1) && !FRowWindow::Test(RowBehind, 2));
+		if (IsForced || InEndPos == Coord)
+		{
+			return Coord;
+		}
+
+		// 양옆 직선 방향에 점프포인트가 있으면 현재 칸이 점프포인트, 목적지가 그 직선 위에 있으면 목적지도 멈출 칸이다
+		// 창 안에서 멈출 칸을 찾지 못하면 창이 끝나는 곳부터 원래의 직선 검사를 이어간다
+		JPS_SEARCH_STAT_ADD(Scans, 2);
+		{
+			uint64 Stop = Row | (RowBehind & ~FRowWindow::Advance(RowBehind)) | (RowAhead & ~FRowWindow::Advance(RowAhead));
+			const int32 EndIndex = (InEndPos.X - X) * InDirX + 1;
+			if (InEndPos.Y == Y && EndIndex >= ScanBegin && EndIndex < ScanEnd)
+			{
+				Stop |= FRowWindow::Cell(EndIndex);
+			}
+			Stop &= FRowWindow::Range(ScanBegin, ScanEnd);
+			if (Stop ? !FRowWindow::Test(Row, FRowWindow::First(Stop)) : !StraightJumpPoint(JPSCoord(X + InDirX * (ScanEnd - 2), Y), RowDir, InEndPos).IsEmpty())
+			{
+				return Coord;
+			}
+		}
+		if (!HasColumns)
+		{
+			ColumnBehind = Grid.LoadWindow<false, (InDirY > 0)>(X - InDirX, Y - InDirY);
+			Column = Grid.LoadWindow<false, (InDirY > 0)>(X, Y - InDirY);
+			ColumnAhead = Grid.LoadWindow<false, (InDirY > 0)>(X + InDirX, Y - InDirY);
+			JPS_SEARCH_STAT_ADD(WordsTouched, 6);
+			HasColumns = true;
+		}
+		{
+			uint64 Stop = Column | (ColumnBehind & ~FColumnWindow::Advance(ColumnBehind)) | (ColumnAhead & ~FColumnWindow::Advance(ColumnAhead));
+			const int32 EndIndex = (InEndPos.Y - Y) * InDirY + 1;
+			if (InEndPos.X == X && EndIndex >= ScanBegin && EndIndex < ScanEnd)
+			{
+				Stop |= FColumnWindow::Cell(EndIndex);
+			}
+			Stop &= FColumnWindow::Range(ScanBegin, ScanEnd);
+			if (Stop ? !FColumnWindow::Test(Column, FColumnWindow::First(Stop)) : !StraightJumpPoint(JPSCoord(X, Y + InDirY * (ScanEnd - 2)), ColumnDir, InEndPos).IsEmpty())
+			{
+				return Coord;
+			}
+		}
+
+		// 점프포인트를 찾지 못했다면 진행방향으로 다음좌표 업데이트
+		X += InDirX;
+		Y += InDirY;
+		RowBehind = FRowWindow::Advance(Row);
+		Row = FRowWindow::Advance(RowAhead);
+		RowAhead = Grid.LoadWindow<true, (InDirX > 0)>(Y + InDirY, X - InDirX);
+		ColumnBehind = FColumnWindow::Advance(Column);
+		Column = FColumnWindow::Advance(ColumnAhead);
+		ColumnAhead = Grid.LoadWindow<false, (InDirY > 0)>(X + InDirX, Y - InDirY);
+		JPS_SEARCH_STAT_ADD(WordsTouched, 4);
+	}
+}
+
+JPSCoord FJPSPathfinder::StraightJumpPoint(const JPSCoord& InCoord, const int32 InDir, const JPSCoord& InEndPos) const
+{
+	// 목적지가 진행방향 직선 위에 있고 벽보다 앞이라면 강제이웃보다 목적지를 먼저 돌려준다
+	switch (InDir)
+	{
+	case 0://North
+		if (InEndPos.X == InCoord.X && InEndPos.Y < InCoord.Y && Grid.GetCloseValue<false, false>(InCoord.X, InCoord.Y - 1) < InEndPos.Y)
+		{
+			return InEndPos;
+		}
+		{
+			const int32 Pos = Grid.FindStraightJumpPoint<false, false>(InCoord.X, InCoord.Y - 1);
+			return Pos >= 0 ? JPSCoord(InCoord.X, Pos) : JPSCoord(-1, -1);
+		}
+	case 2://EAST
+		if (InEndPos.Y == InCoord.Y && InEndPos.X > InCoord.X && Grid.GetCloseValue<true, true>(InCoord.X + 1, InCoord.Y) > InEndPos.X)
+		{
+			return InEndPos;
+		}
+		{
+			const int32 Pos = Grid.FindStraightJumpPoint<true, true>(InCoord.X + 1, InCoord.Y);
+			return Pos < GridWidth ? JPSCoord(Pos, InCoord.Y) : JPSCoord(-1, -1);
+		}
+	case 4://SOUTH
+		if (InEndPos.X == InCoord.X && InEndPos.Y > InCoord.Y && Grid.GetCloseValue<false, true>(InCoord.X, InCoord.Y + 1) > InEndPos.Y)
+		{
+			return InEndPos;
+		}
+		{
+			const int32 Pos = Grid.FindStraightJumpPoint<false, true>(InCoord.X, InCoord.Y + 1);
+			return Pos < GridHeight ? JPSCoord(InCoord.X, Pos) : JPSCoord(-1, -1);
+		}
+	case 6://WEST
+		if (InEndPos.Y == InCoord.Y && InEndPos.X < InCoord.X && Grid.GetCloseValue<true, false>(InCoord.X - 1, InCoord.Y) < InEndPos.X)
+		{
+			return InEndPos;
+		}
+		{
+			const int32 Pos = Grid.FindStraightJumpPoint<true, false>(InCoord.X - 1, InCoord.Y);
+			return Pos >= 0 ? JPSCoord(Pos, InCoord.Y) : JPSCoord(-1, -1);
+		}
+	}
+	return JPSCoord(-1, -1);
+}
+
+JPSCoord FJPSPathfinder::JumpWithTable(const JPSCoord& InCoord, const char InDir, const JPSCoord& InEndPos) const
+{
+	// 양수면 점프포인트까지, 0 이하면 벽 앞까지의 거리, 절대값만큼은 막힘없이 이동할 수 있다
+	const int32 Distance = JumpTable.Get(InCoord.X, InCoord.Y, InDir);
+	const int32 Reach = FMath::Abs(Distance);
+	const JPSCoord Offset = NextCoordinate(JPSCoord(0, 0), InDir);
+	const int32 DiffX = InEndPos.X - InCoord.X;
+	const int32 DiffY = InEndPos.Y - InCoord.Y;
+
+	if (DirIsDiagonal(InDir))
+	{
+		// 목적지가 진행방향의 사분면에 있고 도달 가능한 거리 안에서 목적지와 행이나 열이 같아진다면
+		// 그 지점에서 직선으로 목적지를 찾을 수 있으므로 점프포인트로 삼는다
+		if (DiffX * Offset.X > 0 && DiffY * Offset.Y > 0)
+		{
+			const int32 Steps = FMath::Min(FMath::Abs(DiffX), FMath::Abs(DiffY));
+			if (Steps <= Reach)
+			{
+				return JPSCoord(InCoord.X + Offset.X * Steps, InCoord.Y + Offset.Y * Steps);
+			}
+		}
+	}
+	else
+	{
+		// 목적지가 진행방향 직선 위에 있고 도달 가능한 거리 안이라면 목적지
+		const bool IsOnLine = (Offset.X == 0) ? (DiffX == 0 && DiffY * Offset.Y > 0) : (DiffY == 0 && DiffX * Offset.X > 0);
+		if (IsOnLine && FMath::Abs(DiffX + DiffY) <= Reach)
+		{
+			return InEndPos;
+		}
+	}
+
+	if (Distance > 0)
+	{
+		return JPSCoord(InCoord.X + Offset.X * Distance, InCoord.Y + Offset.Y * Distance);
+	}
+	return JPSCoord(-1, -1);
+}
+
+bool FJPSPathfinder::PullingString(TArray<JPSCoord>& InResultNodes) const
+{
+	// 지그재그인 경로를 직선화
+	if (InResultNodes.Num() <= 2)
+	{
+		return false;
+	}
+
+	int32 BaseNodeIndex = 0;
+	int32 PrevNodeIndex = 1;
+	int32 CurrNodeIndex = 2;
+
+	while (CurrNodeIndex < InResultNodes.Num())
+	{
+		// 출발 노드
+		const JPSCoord& BaseNode = InResultNodes[BaseNodeIndex];
+		// 출발 다음 노드
+		const JPSCoord& CurrNode = InResultNodes[CurrNodeIndex];
+
+		// 기준 노드에서 현재 노드까지 직선으로 도달 가능한지 확인
+		if (IsStraightPassable(BaseNode.X, BaseNode.Y, CurrNode.X, CurrNode.Y))
+		{
+			// 중간 노드 제거
+			InResultNodes.RemoveAt(PrevNodeIndex);
+		}
+		else
+		{
+			// 제거할 수 없다면 기준 노드를 이전 노드로 변경
+			BaseNodeIndex = PrevNodeIndex;
+			PrevNodeIndex = CurrNodeIndex;
+			CurrNodeIndex++;
+		}
+	}
+
+	return InResultNodes.Num() > 0;
+}
+
+bool FJPSPathfinder::IsStraightPassable(int32 InFromX, int32 InFromY, int32 InToX, int32 InToY) const
+{
+	if (!Grid.IsValid())
+	{
+		return false;
+	}
+
+	// 좌표 차이
+	float DiffX = (float)(InToX - InFromX);
+	float DiffY = (float)(InToY - InFromY);
+	// 이동량이 더 큰쪽
+	float Step = FMath::Max(FMath::Abs(DiffX), FMath::Abs(DiffY));
+
+	// 이동 비율
+	float Dx = DiffX / Step;
+	float Dy = DiffY / Step;
+
+	// 이동량만큼 계산
+	for (int i = 0; i <= FMath::CeilToInt(Step); i++)
+	{
+		// 시작위치로부터 목적지까지 대각선을 그어서 해당 위치에 해당하는 셀들을 검사
+		JPSCoord Pos(InFromX + int32(Dx * (float)i), InFromY + int32(Dy * (float)i));
+		// 해당 좌표가 두 좌표 사이에 존재하는지 검사
+		if (FMath::IsWithinInclusive(Pos.X, FMath::Min(InFromX, InToX), FMath::Max(InFromX, InToX)) == false)
+		{
+			continue;
+		}
+
+		if (FMath::IsWithinInclusive(Pos.Y, FMath::Min(InFromY, InToY), FMath::Max(InFromY, InToY)) == false)
+		{
+			continue;
+		}
+
+		// 해당 SPOT이 Passable 검사
+		// 그 중 하나라도 이동 불가능한 노드가 있으면 false
+		if (IsPassable(Pos) == false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,324 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "JPSPlusTable.h"
+#include "JPSBitScan.h"
+
+#include "Async/ParallelFor.h"
+
+// 방향별 이동량, 북 북동 동 남동 남 남서 서 북서
+static const int32 DirX[FJPSPlusTable::NDIR] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+static const int32 DirY[FJPSPlusTable::NDIR] = { -1, -1, 0, 1, 1, 1, 0, -1 };
+
+// 비트배열의 한 행을 복사하고 맵 밖의 비트는 모두 충돌지점으로 채운다
+// 다음 원소를 시프트해서 읽을 수 있도록 맨 뒤에 충돌지점으로 채운 원소를 하나 더 둔다
+static void LoadBlockedRow(const FJPSGridView& InGrid, bool InIsXaxis, int32 InRow, int32 InRows, int32 InLength, TArray<uint64>& OutWords)
+{
+	const int32 WordWidths = InGrid.GetWordWidths(InIsXaxis);
+	OutWords.Init(~0ULL, WordWidths + 1);
+	if (InRow < 0 || InRow >= InRows)
+	{
+		return;
+	}
+
+	FMemory::Memcpy(OutWords.GetData(), InGrid.GetRow(InIsXaxis, InRow), sizeof(uint64) * WordWidths);
+	const int32 LastBits = InLength - (WordWidths - 1) * 64;
+	OutWords[WordWidths - 1] |= ~FJPSBitScan::RangeMask(0, LastBits);
+}
+
+static bool IsBitSet(const uint64* InWords, int32 InIndex)
+{
+	return (InWords[InIndex / 64] >> (InIndex % 64)) & 1;
+}
+
+bool FJPSPlusTable::Build(const FJPSGridView& InGrid)
+{
+	Reset();
+
+	const int32 MapWidth = InGrid.GetWidth();
+	const int32 MapHeight = InGrid.GetHeight();
+	if (MapWidth <= 0 || MapHeight <= 0 || MapWidth > MAX_int16 || MapHeight > MAX_int16 ||
+		(int64)MapWidth * MapHeight * NDIR > MAX_int32)
+	{
+		UE_LOG(LogTemp, Error, TEXT("JPS+ table can not be built for %d x %d map"), MapWidth, MapHeight);
+		return false;
+	}
+
+	Width = MapWidth;
+	Height = MapHeight;
+	Distances.SetNumZeroed(Width * Height * NDIR);
+
+	// 직선 방향은 행(열)마다 독립이다
+	ParallelFor(Height, [this, &InGrid](int32 InRow)
+	{
+		BuildStraightRow(InGrid, true, InRow);
+	});
+	ParallelFor(Width, [this, &InGrid](int32 InColumn)
+	{
+		BuildStraightRow(InGrid, false, InColumn);
+	});
+
+	// 대각선은 다음 칸의 직선 거리를 참조하기 때문에 직선 다음에 계산하고, 대각선 줄마다 독립이다
+	for (int32 Dir = 1; Dir < NDIR; Dir += 2)
+	{
+		const int32 EdgeX = DirX[Dir] > 0 ? Width - 1 : 0;
+		const int32 EdgeY = DirY[Dir] > 0 ? Height - 1 : 0;
+		ParallelFor(Width + Height - 1, [this, &InGrid, Dir, EdgeX, EdgeY](int32 InLine)
+		{
+			// 진행방향 끝의 세로 변에서 시작하는 줄, 나머지는 가로 변에서 시작하는 줄
+			if (InLine < Height)
+			{
+				BuildDiagonalLine(InGrid, Dir, EdgeX, InLine);
+			}
+			else
+			{
+				const int32 Column = InLine - Height;
+				BuildDiagonalLine(InGrid, Dir, DirX[Dir] > 0 ? Column : Column + 1, EdgeY);
+			}
+		});
+	}
+	return true;
+}
+
+void FJPSPlusTable::Reset()
+{
+	Distances.Empty();
+	Width = 0;
+	Height = 0;
+}
+
+bool FJPSPlusTable::Repair(const FJPSGridView& InGrid, int32 InX, int32 InY)
+{
+	if (!IsValid() || InGrid.GetWidth() != Width || InGrid.GetHeight() != Height)
+	{
+		return false;
+	}
+	if (InGrid.IsOutBound(InX, InY))
+	{
+		return true;
+	}
+
+	// 직선 거리는 같은 행(열)과 양옆 행(열)의 충돌 비트로 정해진다
+	const int32 MinX = FMath::Max(InX - 1, 0);
+	const int32 MaxX = FMath::Min(InX + 1, Width - 1);
+	const int32 MinY = FMath::Max(InY - 1, 0);
+	const int32 MaxY = FMath::Min(InY + 1, Height - 1);
+
+	// 다시 계산하기 전의 직선 거리, 행은 동서, 열은 남북 순서로 칸마다 두 개씩 둔다
+	TArray<int16> OldRows;
+	TArray<int16> OldColumns;
+	OldRows.SetNumUninitialized((MaxY - MinY + 1) * Width * 2);
+	OldColumns.SetNumUninitialized((MaxX - MinX + 1) * Height * 2);
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = 0; X < Width; X++)
+		{
+			const int32 Index = ((Y - MinY) * Width + X) * 2;
+			OldRows[Index] = static_cast<int16>(Get(X, Y, 2));
+			OldRows[Index + 1] = static_cast<int16>(Get(X, Y, 6));
+		}
+	}
+	for (int32 X = MinX; X <= MaxX; X++)
+	{
+		for (int32 Y = 0; Y < Height; Y++)
+		{
+			const int32 Index = ((X - MinX) * Height + Y) * 2;
+			OldColumns[Index] = static_cast<int16>(Get(X, Y, 4));
+			OldColumns[Index + 1] = static_cast<int16>(Get(X, Y, 0));
+		}
+	}
+
+	for (int32 Row = MinY; Row <= MaxY; Row++)
+	{
+		BuildStraightRow(InGrid, true, Row);
+	}
+	for (int32 Column = MinX; Column <= MaxX; Column++)
+	{
+		BuildStraightRow(InGrid, false, Column);
+	}
+
+	// 대각선 거리는 다음 칸의 충돌 여부, 다음 칸 주변의 충돌 여부, 다음 칸의 직선 거리 부호로 정해진다
+	// 이 중 하나라도 바뀌었을 수 있는 칸을 모은다, 바뀐 칸 주변 3x3과 직선 거리의 부호가 바뀐 칸
+	TArray<FIntPoint> Seeds;
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = MinX; X <= MaxX; X++)
+		{
+			Seeds.Add(FIntPoint(X, Y));
+		}
+	}
+	auto IsSignChanged = [this](int32 InOldDistance, int32 InCellX, int32 InCellY, int32 InDir)
+	{
+		return (InOldDistance > 0) != (Get(InCellX, InCellY, InDir) > 0);
+	};
+	for (int32 Y = MinY; Y <= MaxY; Y++)
+	{
+		for (int32 X = 0; X < Width; X++)
+		{
+			const int32 Index = ((Y - MinY) * Width + X) * 2;
+			if ((X < MinX || X > MaxX) && (IsSignChanged(OldRows[Index], X, Y, 2) || IsSignChanged(OldRows[Index + 1], X, Y, 6)))
+			{
+				Seeds.Add(FIntPoint(X, Y));
+			}
+		}
+	}
+	for (int32 X = MinX; X <= MaxX; X++)
+	{
+		for (int32 Y = 0; Y < Height; Y++)
+		{
+			const int32 Index = ((X - MinX) * Height + Y) * 2;
+			if ((Y < MinY || Y > MaxY) && (IsSignChanged(OldColumns[Index], X, Y, 4) || IsSignChanged(OldColumns[Index + 1], X, Y, 0)))
+			{
+				Seeds.Add(FIntPoint(X, Y));
+			}
+		}
+	}
+
+	for (int32 Dir = 1; Dir < NDIR; Dir += 2)
+	{
+		// 진행방향으로 먼 칸부터 거슬러 올라가야 앞에서 고친 값을 뒤의 칸이 이어받는다
+		Seeds.Sort([Dir](const FIntPoint& InA, const FIntPoint& InB)
+		{
+			return InA.X * DirX[Dir] + InA.Y * DirY[Dir] > InB.X * DirX[Dir] + InB.Y * DirY[Dir];
+		});
+
+		for (const FIntPoint& Seed : Seeds)
+		{
+			// 값이 그대로인 칸을 만나면 그보다 뒤의 칸도 그대로다
+			int32 NextDistance = Get(Seed.X, Seed.Y, Dir);
+			for (int32 X = Seed.X - DirX[Dir], Y = Seed.Y - DirY[Dir]; !InGrid.IsOutBound(X, Y); X -= DirX[Dir], Y -= DirY[Dir])
+			{
+				const int32 Distance = ComputeDiagonal(InGrid, X, Y, Dir, NextDistance);
+				if (Distance == Get(X, Y, Dir))
+				{
+					break;
+				}
+				Set(X, Y, Dir, Distance);
+				NextDistance = Distance;
+			}
+		}
+	}
+	return true;
+}
+
+void FJPSPlusTable::BuildStraightRow(const FJPSGridView& InGrid, bool InIsXaxis, int32 InRow)
+{
+	const int32 Length = InIsXaxis ? Width : Height;
+	const int32 Rows = InIsXaxis ? Height : Width;
+	const int32 WordWidths = InGrid.GetWordWidths(InIsXaxis);
+	// 정방향은 X축이면 동쪽, Y축이면 남쪽
+	const int32 ForwardDir = InIsXaxis ? 2 : 4;
+	const int32 BackwardDir = InIsXaxis ? 6 : 0;
+
+	// 이전 행, 현재 행, 다음 행의 충돌 비트
+	TArray<uint64> Blocked[3];
+	for (int32 Index = 0; Index < 3; Index++)
+	{
+		LoadBlockedRow(InGrid, InIsXaxis, InRow + Index - 1, Rows, Length, Blocked[Index]);
+	}
+
+	// 옆 행의 칸이 막혀있고 진행방향으로 그 다음 칸이 열려있으면 강제이웃이 생긴다
+	// 원소 단위로 64칸씩 한번에 계산한다
+	TArray<uint64> ForwardForced;
+	TArray<uint64> BackwardForced;
+	ForwardForced.SetNumZeroed(WordWidths);
+	BackwardForced.SetNumZeroed(WordWidths);
+	for (int32 Side = 0; Side < 3; Side += 2)
+	{
+		const uint64* SideWords = Blocked[Side].GetData();
+		for (int32 Word = 0; Word < WordWidths; Word++)
+		{
+			const uint64 OpenNext = ~((SideWords[Word] >> 1) | (SideWords[Word + 1] << 63));
+			const uint64 OpenPrev = ~((SideWords[Word] << 1) | (Word > 0 ? SideWords[Word - 1] >> 63 : 1ULL));
+			ForwardForced[Word] |= OpenNext & SideWords[Word];
+			BackwardForced[Word] |= OpenPrev & SideWords[Word];
+		}
+	}
+
+	const uint64* Self = Blocked[1].GetData();
+	auto SetCell = [this, InIsXaxis, InRow](int32 InIndex, int32 InDir, int32 InDistance)
+	{
+		Set(InIsXaxis ? InIndex : InRow, InIsXaxis ? InRow : InIndex, InDir, InDistance);
+	};
+
+	// 다음 칸이 막혀있으면 0, 다음 칸이 점프포인트면 1, 아니면 다음 칸의 거리에서 한 칸 늘린다
+	int32 Distance = 0;
+	for (int32 Index = Length - 1; Index >= 0; Index--)
+	{
+		const int32 Next = Index + 1;
+		if (Next >= Length || IsBitSet(Self, Next))
+		{
+			Distance = 0;
+		}
+		else if (IsBitSet(ForwardForced.GetData(), Next))
+		{
+			Distance = 1;
+		}
+		else
+		{
+			Distance = Distance > 0 ? Distance + 1 : Distance - 1;
+		}
+		SetCell(Index, ForwardDir, Distance);
+	}
+
+	Distance = 0;
+	for (int32 Index = 0; Index < Length; Index++)
+	{
+		const int32 Next = Index - 1;
+		if (Next < 0 || IsBitSet(Self, Next))
+		{
+			Distance = 0;
+		}
+		else if (IsBitSet(BackwardForced.GetData(), Next))
+		{
+			Distance = 1;
+		}
+		else
+		{
+			Distance = Distance > 0 ? Distance + 1 : Distance - 1;
+		}
+		SetCell(Index, BackwardDir, Distance);
+	}
+}
+
+void FJPSPlusTable::BuildDiagonalLine(const FJPSGridView& InGrid, int32 InDir, int32 InStartX, int32 InStartY)
+{
+	// 진행방향의 반대로 거슬러 올라가면서 다음 칸의 값으로 현재 칸을 계산한다
+	int32 Distance = 0;
+	for (int32 X = InStartX, Y = InStartY; !InGrid.IsOutBound(X, Y); X -= DirX[InDir], Y -= DirY[InDir])
+	{
+		Distance = ComputeDiagonal(InGrid, X, Y, InDir, Distance);
+		Set(X, Y, InDir, Distance);
+	}
+}
+
+int32 FJPSPlusTable::ComputeDiagonal(const FJPSGridView& InGrid, int32 InX, int32 InY, int32 InDir, int32 InNextDistance) const
+{
+	auto IsOpen = [&InGrid](int32 InCellX, int32 InCellY)
+	{
+		return !InGrid.IsCollision(InCellX, InCellY);
+	};
+
+	const int32 NextX = InX + DirX[InDir];
+	const int32 NextY = InY + DirY[InDir];
+	if (!IsOpen(NextX, NextY))
+	{
+		return 0;
+	}
+
+	// UJPSPath::GetForcedNeighbours의 대각선 조건과 같다
+	const int32 Side1 = (InDir + 6) % NDIR;
+	const int32 Back1 = (InDir + 5) % NDIR;
+	const int32 Side2 = (InDir + 2) % NDIR;
+	const int32 Back2 = (InDir + 3) % NDIR;
+	const bool IsForced =
+		(IsOpen(NextX + DirX[Side1], NextY + DirY[Side1]) && !IsOpen(NextX + DirX[Back1], NextY + DirY[Back1])) ||
+		(IsOpen(NextX + DirX[Side2], NextY + DirY[Side2]) && !IsOpen(NextX + DirX[Back2], NextY + DirY[Back2]));
+
+	// 다음 칸에서 대각선을 이루는 두 직선 방향으로 점프포인트가 있어도 다음 칸이 점프포인트다
+	if (IsForced || Get(NextX, NextY, (InDir + 1) % NDIR) > 0 || Get(NextX, NextY, (InDir + 7) % NDIR) > 0)
+	{
+		return 1;
+	}
+	return InNextDistance > 0 ? InNextDistance + 1 : InNextDistance - 1;
+}
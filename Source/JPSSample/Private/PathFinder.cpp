@@ -5,16 +5,65 @@
 
 #include "AStarCollision.h"
 #include "JPSCollision.h"
+#include "JPSPath.h"
+#include "JPSBitScan.h"
+#include "JPSMovingAI.h"
+#include "JPSCorpus.h"
 #include "Maze.h"
 #include "NavigationPath.h"
 #include "NavigationSystem.h"
 #include "AI/Navigation/NavigationTypes.h"
 #include "ProfilingDebugging/ScopedTimers.h"
+#include "Misc/Paths.h"
 #include "DrawDebugHelpers.h"
 
 static const int32 DY[4] = { -1,1,0,0 };
 static const int32 DX[4] = { 0,0,-1,1 };
 
+// 측정값 묶음의 요약, 시간은 초 단위
+struct FSimulateSummary
+{
+	int32 Samples = 0;
+	// 양 끝을 잘라내고 남은 표본 수
+	int32 Used = 0;
+	double TrimmedMean = 0.0;
+	double Median = 0.0;
+	double Min = 0.0;
+	double Max = 0.0;
+};
+
+// 정렬한 표본의 양 끝에서 InTrimRatio만큼씩 버리고 평균을 낸다, 중앙값과 최소, 최대는 전체 표본 기준
+static FSimulateSummary SummarizeSamples(TArray<double> InSamples, float InTrimRatio)
+{
+	FSimulateSummary Summary;
+	Summary.Samples = InSamples.Num();
+	if (InSamples.Num() == 0)
+	{
+		return Summary;
+	}
+
+	InSamples.Sort();
+	Summary.Median = InSamples[InSamples.Num() / 2];
+	Summary.Min = InSamples[0];
+	Summary.Max = InSamples.Last();
+
+	// 적어도 하나는 남긴다
+	const int32 Trim = FMath::Min(FMath::FloorToInt(InSamples.Num() * FMath::Clamp(InTrimRatio, 0.0f, 0.5f)), (InSamples.Num() - 1) / 2);
+	for (int32 Index = Trim; Index < InSamples.Num() - Trim; Index++)
+	{
+		Summary.TrimmedMean += InSamples[Index];
+	}
+	Summary.Used = InSamples.Num() - Trim * 2;
+	Summary.TrimmedMean /= Summary.Used;
+	return Summary;
+}
+
+static void LogSimulateSummary(const TCHAR* InPhase, const FSimulateSummary& InSummary)
+{
+	UE_LOG(LogTemp, Log, TEXT("%-12s [Samples = %d] [Used = %d] [Trimmed Mean : %.3f ms] [Median : %.3f ms] [Min : %.3f ms] [Max : %.3f ms]"),
+		InPhase, InSummary.Samples, InSummary.Used, InSummary.TrimmedMean * 1000.0, InSummary.Median * 1000.0, InSummary.Min * 1000.0, InSummary.Max * 1000.0);
+}
+
 // Sets default values
 APathFinder::APathFinder()
 {
@@ -36,8 +85,15 @@ APathFinder::APathFinder()
 	NavmeshDebug = false;
 	ShowMapTime = 10.0f;
 	MapType = EMapType::None;
+	MapSeed = 1;
 
 	PathFindingSimulateCount = 10;
+	PathFindingQueryCount = 16;
+	PathFindingWarmupCount = 2;
+	PathFindingTrimRatio = 0.1f;
+	OpenListBenchmarkCount = 10;
+	BitScanBenchmarkCount = 100000;
+	BatchBenchmarkCount = 512;
 
 	StartCoord = { -1,-1 };
 	EndCoord = { -1,-1 };
@@ -48,20 +104,57 @@ APathFinder::APathFinder()
 	JPSTime = 0.0;
 }
 
-void APathFinder::BuildMap()
+void APathFinder::CreateCollisionMaps()
 {
-	if (IsValid(AStarCollision))
-	{
-		AStarCollision->BuildMap(Width, Height);
-	}
-
 	if (IsValid(JPSCollision))
 	{
+		if (!MapChangedHandle.IsValid())
+		{
+			MapChangedHandle = JPSCollision->OnMapChanged().AddUObject(this, &APathFinder::OnJPSMapChanged);
+		}
+
 		JPSCollision->SetWidth(Width);
 		JPSCollision->SetHeight(Height);
 		JPSCollision->BuildMap();
 	}
 
+	if (IsValid(AStarCollision))
+	{
+		// 같은 맵을 두 번 만들지 않도록 JPS의 비트배열을 그대로 읽는다, BuildMap이 다시 할당하므로 매번 새로 공유한다
+		if (IsValid(JPSCollision))
+		{
+			AStarCollision->ShareGrid(JPSCollision->GetGridView());
+		}
+		else
+		{
+			AStarCollision->BuildMap(Width, Height);
+		}
+	}
+}
+
+void APathFinder::OnJPSMapChanged(const FJPSMapChange& InChange)
+{
+	// AStar가 JPS 맵을 공유하고 있으면 같이 따라간다
+	if (!IsValid(AStarCollision) || !AStarCollision->IsSharingGrid() || !IsValid(JPSCollision))
+	{
+		return;
+	}
+
+	if (InChange.bFullRebuild)
+	{
+		// 비트배열을 다시 할당했을 수 있으므로 뷰를 다시 받는다, 이웃 마스크는 BuildPrecomputedData에서 다시 만든다
+		AStarCollision->ShareGrid(JPSCollision->GetGridView());
+	}
+	else
+	{
+		AStarCollision->UpdateNeighbourMasks(InChange.DirtyRects);
+	}
+}
+
+void APathFinder::BuildMap()
+{
+	CreateCollisionMaps();
+
 	if (MapType == EMapType::Navmesh)
 	{
 		FVector CurrentLocation = GetActorLocation();
@@ -102,110 +195,14 @@ void APathFinder::BuildMap()
 
 void APathFinder::InitData()
 {
-	switch (MapType)
-	{
-	case EMapType::None:
+	FJPSMovingAIMap Map;
+	if (GenerateMap(MapSeed, Map))
 	{
-		StartCoord = { 0, 0 };
-		EndCoord = { Width - 1, Height - 1 };
+		ApplyBitmap(Map.Bitmap, Map.WordWidths);
 	}
-		break;
-	case EMapType::Random:
-	{
-		StartCoord = { 0, 0 };
-		EndCoord = { Width - 1, Height - 1 };
-		float ObstacleRatio = 0.3f;
-		for (int32 GridY = 0; GridY < Height; GridY++)
-		{
-			for (int32 GridX = 0; GridX < Width; GridX++)
-			{
-				float RandVal = FMath::RandRange(0.f, 1.f);
-				if (RandVal < ObstacleRatio)
-				{
-					if (IsValid(JPSCollision))
-					{
-						JPSCollision->SetAt(GridY, GridX);
-					}
 
-					if (IsValid(AStarCollision))
-					{
-						AStarCollision->SetNodeAccessibility(GridY, GridX, false);
-					}
-				}
-			}
-		}
-	}
-		break;
-	case EMapType::Maze:
-	{
-		TArray<TArray<uint8>> GridMap = GenerateMaze(Width);
-		for (int32 GridY = 0; GridY < Height; GridY++)
-		{
-			for (int32 GridX = 0; GridX < Width; GridX++)
-			{
-				bool IsValidCell = GridMap.IsValidIndex(GridX) && GridMap[GridX].IsValidIndex(GridY);
-				if (!IsValidCell || GridMap[GridX][GridY] == 1)
-				{
-					if (IsValid(JPSCollision))
-					{
-						JPSCollision->SetAt(GridY, GridX);
-					}
-
-					if (IsValid(AStarCollision))
-					{
-						AStarCollision->SetNodeAccessibility(GridY, GridX, false);
-					}
-				}
-			}
-		}
-	}
-		break;
-	case EMapType::Room:
-	{
-		TArray<TArray<uint8>> GridMap = GenerateRoomsMap(Width);
-		for (int32 GridY = 0; GridY < GridMap.Num(); GridY++)
-		{
-			for (int32 GridX = 0; GridX < GridMap[GridY].Num(); GridX++)
-			{
-				if (GridMap[GridX][GridY] == 1)
-				{
-					if (IsValid(JPSCollision))
-					{
-						JPSCollision->SetAt(GridY, GridX);
-					}
-
-					if (IsValid(AStarCollision))
-					{
-						AStarCollision->SetNodeAccessibility(GridY, GridX, false);
-					}
-				}
-			}
-		}
-	}
-		break;
-	case EMapType::Block:
+	switch (MapType)
 	{
-		TArray<TArray<uint8>> GridMap = GenerateBlock(Width);
-		for (int32 GridY = 0; GridY < GridMap.Num(); GridY++)
-		{
-			for (int32 GridX = 0; GridX < GridMap[GridY].Num(); GridX++)
-			{
-				if (GridMap[GridX][GridY] == 1)
-				{
-					if (IsValid(JPSCollision))
-					{
-						JPSCollision->SetAt(GridY, GridX);
-					}
-
-					if (IsValid(AStarCollision))
-					{
-						AStarCollision->SetNodeAccessibility(GridY, GridX, false);
-					}
-				}
-			}
-		}
-	}
-		break;
 	case EMapType::Navmesh:
 	{
 		const UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
@@ -223,6 +220,11 @@ void APathFinder::InitData()
 
 		FVector CenterLoc = GetActorLocation();
 		FVector2D LeftTop = FVector2D(CenterLoc.X + (Height * IntervalX / 2.0f), CenterLoc.Y - (Width * IntervalY / 2.0f));
+		// 칸마다 변경을 알리지 않고 다 채운 다음 한 버전으로 알린다
+		if (IsValid(JPSCollision))
+		{
+			JPSCollision->BeginMapEdit();
+		}
 		for (int32 GridY = 0; GridY < Height; GridY++)
 		{
 			for (int32 GridX = 0; GridX < Width; GridX++)
@@ -238,13 +240,17 @@ void APathFinder::InitData()
 						JPSCollision->SetAt(GridX, GridY);
 					}
 
-					if (IsValid(AStarCollision))
+					if (IsValid(AStarCollision) && !AStarCollision->IsSharingGrid())
 					{
 						AStarCollision->SetNodeAccessibility(GridX, GridY, false);
 					}
 				}
 			}
 		}
+		if (IsValid(JPSCollision))
+		{
+			JPSCollision->EndMapEdit();
+		}
 
 		FNavLocation StartNavLocation;
 		if (!NavSystem->GetRandomPointInNavigableRadius(StartActor->GetActorLocation(), IntervalX / 2.0f, StartNavLocation))
@@ -267,6 +273,149 @@ void APathFinder::InitData()
 	default:
 		break;
 	}
+	// 맵을 모두 채운 다음 JPS+ 테이블과 목적지 경계 상자를 만든다
+	BuildPrecomputedData();
+}
+
+void APathFinder::BuildPrecomputedData()
+{
+	if (IsValid(JPSCollision) && JPSCollision->bUseJPSPlus)
+	{
+		JPSCollision->BuildJPSPlus();
+	}
+	if (IsValid(JPSCollision) && JPSCollision->bUseGoalBounds)
+	{
+		JPSCollision->BuildGoalBounds();
+	}
+	if (IsValid(AStarCollision) && AStarCollision->bUseNeighbourMasks)
+	{
+		AStarCollision->BuildNeighbourMasks();
+	}
+}
+
+TArray<FPathRequest> APathFinder::MakeSimulateQueries(const FJPSMovingAIMap& InMap, int32 InCount, int32 InSeed) const
+{
+	// 첫 요청은 맵 생성기가 정한 시작/목적지, 나머지는 이동 가능한 칸 중에서 시드로 뽑는다
+	TArray<FPathRequest> Queries;
+	FPathRequest& First = Queries.AddDefaulted_GetRef();
+	First.Start = StartCoord;
+	First.End = EndCoord;
+
+	FRandomStream RandomStream(InSeed);
+	int32 Attempts = 0;
+	while (Queries.Num() < InCount && Attempts++ < InCount * 100)
+	{
+		FPathRequest Request;
+		Request.Start = FIntPoint(RandomStream.RandRange(0, InMap.Width - 1), RandomStream.RandRange(0, InMap.Height - 1));
+		Request.End = FIntPoint(RandomStream.RandRange(0, InMap.Width - 1), RandomStream.RandRange(0, InMap.Height - 1));
+		if (Request.Start != Request.End && !InMap.IsCollision(Request.Start.X, Request.Start.Y) && !InMap.IsCollision(Request.End.X, Request.End.Y))
+		{
+			Queries.Add(Request);
+		}
+	}
+	return Queries;
+}
+
+bool APathFinder::GenerateMap(int32 InSeed, FJPSMovingAIMap& OutMap)
+{
+	OutMap.Width = Width;
+	OutMap.Height = Height;
+	OutMap.WordWidths = FMath::DivideAndRoundUp(Width, 64);
+	OutMap.Bitmap.Reset();
+	OutMap.Bitmap.SetNumZeroed(OutMap.WordWidths * Height);
+
+	switch (MapType)
+	{
+	case EMapType::None:
+	{
+		StartCoord = { 0, 0 };
+		EndCoord = { Width - 1, Height - 1 };
+	}
+		return true;
+	case EMapType::Random:
+	{
+		StartCoord = { 0, 0 };
+		EndCoord = { Width - 1, Height - 1 };
+		float ObstacleRatio = 0.3f;
+		// 행 우선 비트버퍼에 장애물을 기록
+		FRandomStream RandomStream(InSeed);
+		for (int32 GridY = 0; GridY < Height; GridY++)
+		{
+			for (int32 GridX = 0; GridX < Width; GridX++)
+			{
+				float RandVal = RandomStream.FRand();
+				if (RandVal < ObstacleRatio)
+				{
+					OutMap.Bitmap[GridY * OutMap.WordWidths + GridX / 64] |= 1ULL << (GridX % 64);
+				}
+			}
+		}
+	}
+		return true;
+	case EMapType::Maze:
+	{
+		TArray<TArray<uint8>> GridMap = GenerateMaze(Width, InSeed);
+		// 생성된 미로보다 큰 영역은 벽으로 채운다
+		GridMapToBitmap(GridMap, true, OutMap);
+	}
+		return true;
+	case EMapType::Room:
+	{
+		TArray<TArray<uint8>> GridMap = GenerateRoomsMap(Width, InSeed);
+		GridMapToBitmap(GridMap, false, OutMap);
+	}
+		return true;
+	case EMapType::Block:
+	{
+		TArray<TArray<uint8>> GridMap = GenerateBlock(Width, InSeed);
+		GridMapToBitmap(GridMap, false, OutMap);
+	}
+		return true;
+	default:
+		return false;
+	}
+}
+
+void APathFinder::GridMapToBitmap(const TArray<TArray<uint8>>& InGridMap, bool InBlockOutside, FJPSMovingAIMap& OutMap) const
+{
+	// GridMap[y][x] == 1 인 칸을 행 우선 비트버퍼로 변환
+	OutMap.Width = Width;
+	OutMap.Height = Height;
+	OutMap.WordWidths = FMath::DivideAndRoundUp(Width, 64);
+	OutMap.Bitmap.Reset();
+	OutMap.Bitmap.SetNumZeroed(OutMap.WordWidths * Height);
+	for (int32 GridY = 0; GridY < Height; GridY++)
+	{
+		for (int32 GridX = 0; GridX < Width; GridX++)
+		{
+			bool IsValidCell = InGridMap.IsValidIndex(GridY) && InGridMap[GridY].IsValidIndex(GridX);
+			if (IsValidCell ? InGridMap[GridY][GridX] == 1 : InBlockOutside)
+			{
+				OutMap.Bitmap[GridY * OutMap.WordWidths + GridX / 64] |= 1ULL << (GridX % 64);
+			}
+		}
+	}
+}
+
+void APathFinder::ApplyGridMap(const TArray<TArray<uint8>>& InGridMap, bool InBlockOutside)
+{
+	FJPSMovingAIMap Map;
+	GridMapToBitmap(InGridMap, InBlockOutside, Map);
+	ApplyBitmap(Map.Bitmap, Map.WordWidths);
+}
+
+void APathFinder::ApplyBitmap(const TArray<uint64>& InBitmap, int32 InWordWidths)
+{
+	if (IsValid(JPSCollision))
+	{
+		JPSCollision->ApplyBitmap(InBitmap, InWordWidths);
+	}
+
+	// 공유중이면 위에서 이미 반영되었다
+	if (IsValid(AStarCollision) && !AStarCollision->IsSharingGrid())
+	{
+		AStarCollision->ApplyBitmap(InBitmap, InWordWidths);
+	}
 }
 
 void APathFinder::PathFinding()
@@ -423,15 +572,388 @@ void APathFinder::PathFindingSimulate()
 	JPSTime = 0.0;
 	AStarCount = 0;
 	JPSCount = 0;
+
+	// 입력 파일에 같은 조건의 맵이 있으면 생성하지 않고 읽는다
+	FJPSCorpus Corpus;
+	if (!CorpusPath.IsEmpty())
+	{
+		Corpus.Load(CorpusPath);
+	}
+
+	// 맵 생성 비용과 탐색 비용을 따로 개선할 수 있도록 단계별로 잰다
+	TArray<double> BuildMapTimes;
+	TArray<double> InitDataTimes;
+	TArray<double> AStarQueryTimes;
+	TArray<double> JPSQueryTimes;
+	const int32 QueryCount = FMath::Max(PathFindingQueryCount, 1);
+
+	// 워밍업 요청이 측정 구간에서 캐시로 바로 돌아오지 않도록 경로 캐시를 끄고 잰다
+	const int32 PrevPathCacheCapacity = IsValid(JPSCollision) ? JPSCollision->PathCacheCapacity : 0;
+	if (IsValid(JPSCollision))
+	{
+		JPSCollision->ResetPathCache();
+		JPSCollision->PathCacheCapacity = 0;
+	}
+
 	for (int32 Count = 0; Count < PathFindingSimulateCount; Count++)
 	{
-		BuildMap();
-		InitData();
-		PathFinding();
+		double BuildMapTime = 0.0;
+		double InitDataTime = 0.0;
+		TArray<FPathRequest> Queries;
+
+		// 내비메시 맵은 월드에 따라 달라지기 때문에 저장하지 않고, 시작/목적지도 액터 위치로 정해진다
+		if (MapType == EMapType::Navmesh)
+		{
+			{
+				FDurationTimer BuildMapTimer(BuildMapTime);
+				BuildMap();
+				BuildMapTimer.Stop();
+			}
+			{
+				FDurationTimer InitDataTimer(InitDataTime);
+				InitData();
+				InitDataTimer.Stop();
+			}
+			FPathRequest& Query = Queries.AddDefaulted_GetRef();
+			Query.Start = StartCoord;
+			Query.End = EndCoord;
+		}
+		else
+		{
+			const int32 Seed = MapSeed + Count;
+			const FString EntryName = FString::Printf(TEXT("%s-%dx%d-%d-q%d"), *UEnum::GetValueAsString(MapType), Width, Height, Seed, QueryCount);
+			const FJPSCorpusEntry* Entry = Corpus.Find(EntryName);
+			if (!Entry)
+			{
+				// 생성은 InitData 단계에 포함한다, 입력 파일에서 읽으면 이 비용이 빠진다
+				FDurationTimer GenerateTimer(InitDataTime);
+				FJPSCorpusEntry NewEntry;
+				NewEntry.Name = EntryName;
+				NewEntry.Seed = Seed;
+				GenerateMap(Seed, NewEntry.Map);
+				NewEntry.Queries = MakeSimulateQueries(NewEntry.Map, QueryCount, Seed);
+				GenerateTimer.Stop();
+				Entry = &Corpus.Add(MoveTemp(NewEntry));
+			}
+
+			{
+				FDurationTimer BuildMapTimer(BuildMapTime);
+				BuildMap();
+				BuildMapTimer.Stop();
+			}
+			{
+				FDurationTimer InitDataTimer(InitDataTime);
+				ApplyBitmap(Entry->Map.Bitmap, Entry->Map.WordWidths);
+				BuildPrecomputedData();
+				InitDataTimer.Stop();
+			}
+			Queries = Entry->Queries;
+		}
+		BuildMapTimes.Add(BuildMapTime);
+		InitDataTimes.Add(InitDataTime);
+
+		// 앞의 요청들로 컨텍스트 버퍼를 채운 다음 측정한다
+		const int32 WarmupCount = FMath::Max(PathFindingWarmupCount, 0);
+		for (int32 Index = 0; Index < WarmupCount + Queries.Num(); Index++)
+		{
+			const bool bWarmup = Index < WarmupCount;
+			const FPathRequest& Query = Queries[bWarmup ? Index % Queries.Num() : Index - WarmupCount];
+			StartCoord = Query.Start;
+			EndCoord = Query.End;
+
+			const double PrevAStarTime = AStarTime;
+			const double PrevJPSTime = JPSTime;
+			const int32 PrevAStarCount = AStarCount;
+			const int32 PrevJPSCount = JPSCount;
+			PathFinding();
+			if (bWarmup)
+			{
+				continue;
+			}
+			if (AStarCount > PrevAStarCount)
+			{
+				AStarQueryTimes.Add(AStarTime - PrevAStarTime);
+			}
+			if (JPSCount > PrevJPSCount)
+			{
+				JPSQueryTimes.Add(JPSTime - PrevJPSTime);
+			}
+		}
+	}
+
+	if (IsValid(JPSCollision))
+	{
+		JPSCollision->PathCacheCapacity = PrevPathCacheCapacity;
+	}
+
+	if (!CorpusPath.IsEmpty() && Corpus.IsDirty())
+	{
+		Corpus.Save(CorpusPath);
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("PathFinding Simulate [MapType = %s] [TestMapSize = %d x %d] [Maps = %d] [Queries = %d] [Warmup = %d] [Trim = %.0f%%]"),
+		*UEnum::GetValueAsString(MapType), Width, Height, PathFindingSimulateCount, QueryCount, PathFindingWarmupCount, PathFindingTrimRatio * 100.0f);
+	LogSimulateSummary(TEXT("BuildMap"), SummarizeSamples(BuildMapTimes, PathFindingTrimRatio));
+	LogSimulateSummary(TEXT("InitData"), SummarizeSamples(InitDataTimes, PathFindingTrimRatio));
+	LogSimulateSummary(TEXT("AStar Query"), SummarizeSamples(AStarQueryTimes, PathFindingTrimRatio));
+	LogSimulateSummary(TEXT("JPS Query"), SummarizeSamples(JPSQueryTimes, PathFindingTrimRatio));
+}
+
+void APathFinder::OpenListBenchmark()
+{
+	if (!IsValid(JPSCollision))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Not Exist JPSCollision"));
+		return;
+	}
+
+	const int32 PrevWidth = Width;
+	const int32 PrevHeight = Height;
+	const EMapType PrevMapType = MapType;
+	const EJPSOpenListType PrevOpenListType = JPSCollision->OpenListType;
+	// 같은 요청을 반복하므로 경로 캐시를 끄지 않으면 첫 번째 외에는 캐시 시간이 된다
+	const int32 PrevPathCacheCapacity = JPSCollision->PathCacheCapacity;
+	JPSCollision->ResetPathCache();
+	JPSCollision->PathCacheCapacity = 0;
+
+	// 같은 맵에서 두 오픈리스트를 번갈아 측정한다
+	const EMapType MapTypes[] = { EMapType::Random, EMapType::Room, EMapType::Block };
+	const int32 MapSizes[] = { 512, 2048, 8192 };
+	const EJPSOpenListType OpenListTypes[] = { EJPSOpenListType::BinaryHeap, EJPSOpenListType::RadixHeap };
+
+	for (EMapType BenchmarkMapType : MapTypes)
+	{
+		for (int32 MapSize : MapSizes)
+		{
+			Width = MapSize;
+			Height = MapSize;
+			MapType = BenchmarkMapType;
+			BuildMap();
+			InitData();
+
+			for (EJPSOpenListType OpenListType : OpenListTypes)
+			{
+				JPSCollision->SetOpenListType(OpenListType);
+
+				TArray<FIntPoint> PathResults;
+				double OpenListTime = 0.0;
+				{
+					FDurationTimer OpenListTimer(OpenListTime);
+					for (int32 Count = 0; Count < OpenListBenchmarkCount; Count++)
+					{
+						JPSCollision->FindPath(StartCoord, EndCoord, PathResults);
+					}
+					OpenListTimer.Stop();
+				}
+
+				const FJPSSearchStats Stats = JPSCollision->GetLastSearchStats();
+				UE_LOG(LogTemp, Log, TEXT("JPS OpenList [%s] [MapType = %s] [TestMapSize = %d x %d] [Path Length : %d] [Average Time : %f] [Pops : %d] [Pushes : %d] [DecreaseKeys : %d] [Words : %lld]"),
+					*UEnum::GetValueAsString(OpenListType), *UEnum::GetValueAsString(BenchmarkMapType), MapSize, MapSize, PathResults.Num(), (float)(OpenListTime / FMath::Max(OpenListBenchmarkCount, 1)),
+					Stats.HeapPops, Stats.HeapPushes, Stats.HeapDecreaseKeys, Stats.WordsTouched);
+			}
+		}
+	}
+
+	Width = PrevWidth;
+	Height = PrevHeight;
+	MapType = PrevMapType;
+	JPSCollision->SetOpenListType(PrevOpenListType);
+	JPSCollision->PathCacheCapacity = PrevPathCacheCapacity;
+}
+
+void APathFinder::BitScanBenchmark()
+{
+	// 4096칸 너비의 행에서 맨 끝의 충돌지점을 찾는 시간을 원소를 하나씩 검사하는 방식과 비교한다
+	const int32 RowWidth = 4096;
+	const int32 WordCount = RowWidth / 64;
+	TArray<uint64> Row;
+	Row.Init(0, WordCount);
+	Row.Last() = 1ULL << 63;
+
+	int64 Checksum = 0;
+	double SingleTime = 0.0;
+	{
+		FDurationTimer SingleTimer(SingleTime);
+		for (int32 Count = 0; Count < BitScanBenchmarkCount; Count++)
+		{
+			int32 Word = Count & 3;
+			while (Word < WordCount && Row[Word] == 0)
+			{
+				Word++;
+			}
+			Checksum += Word;
+		}
+		SingleTimer.Stop();
+	}
+
+	double GroupTime = 0.0;
+	{
+		FDurationTimer GroupTimer(GroupTime);
+		for (int32 Count = 0; Count < BitScanBenchmarkCount; Count++)
+		{
+			Checksum += FJPSBitScan::FindForward(Row.GetData(), Count & 3, WordCount, 0ULL);
+		}
+		GroupTimer.Stop();
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("BitScan [RowWidth = %d] [Test Count = %d] [AVX2 = %d] [Single Word : %f] [Word Group : %f] [Speedup : %.2fx] [Checksum : %lld]"),
+		RowWidth, BitScanBenchmarkCount, PLATFORM_ALWAYS_HAS_AVX_2, (float)SingleTime, (float)GroupTime, (float)(SingleTime / FMath::Max(GroupTime, 1e-9)), Checksum);
+}
+
+void APathFinder::BatchBenchmark()
+{
+	if (!IsValid(JPSCollision))
+	{
+		UE_LOG(LogTemp, Error, TEXT("Not Exist JPSCollision"));
+		return;
+	}
+
+	// 현재 맵에서 이동 가능한 칸끼리 시드로 정해지는 요청을 만든다
+	TArray<FPathRequest> Requests;
+	FRandomStream RandomStream(MapSeed);
+	int32 Attempts = 0;
+	while (Requests.Num() < BatchBenchmarkCount && Attempts++ < BatchBenchmarkCount * 100)
+	{
+		FPathRequest Request;
+		Request.Start = FIntPoint(RandomStream.RandRange(0, Width - 1), RandomStream.RandRange(0, Height - 1));
+		Request.End = FIntPoint(RandomStream.RandRange(0, Width - 1), RandomStream.RandRange(0, Height - 1));
+		if (!JPSCollision->IsCollision(Request.Start.X, Request.Start.Y) && !JPSCollision->IsCollision(Request.End.X, Request.End.Y))
+		{
+			Requests.Add(Request);
+		}
+	}
+
+	// 같은 요청을 게임 스레드에서 하나씩 탐색한 시간과 비교한다, 배치처럼 경로 캐시를 거치지 않는다
+	const int32 PrevPathCacheCapacity = JPSCollision->PathCacheCapacity;
+	JPSCollision->ResetPathCache();
+	JPSCollision->PathCacheCapacity = 0;
+	int32 SerialFound = 0;
+	double SerialTime = 0.0;
+	{
+		FDurationTimer SerialTimer(SerialTime);
+		TArray<FIntPoint> PathResults;
+		for (const FPathRequest& Request : Requests)
+		{
+			PathResults.Reset();
+			JPSCollision->FindPath(Request.Start, Request.End, PathResults);
+			SerialFound += PathResults.Num() > 0 ? 1 : 0;
+		}
+		SerialTimer.Stop();
+	}
+	JPSCollision->PathCacheCapacity = PrevPathCacheCapacity;
+
+	TArray<FPathResult> Results;
+	Results.SetNum(Requests.Num());
+	double BatchTime = 0.0;
+	{
+		FDurationTimer BatchTimer(BatchTime);
+		JPSCollision->FindPathBatch(Requests, Results);
+		BatchTimer.Stop();
+	}
+
+	int32 BatchFound = 0;
+	for (const FPathResult& Result : Results)
+	{
+		BatchFound += Result.bFound ? 1 : 0;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("JPS Batch [MapType = %s] [TestMapSize = %d x %d] [Requests = %d] [Workers = %d] [Found : %d / %d] [Serial : %f] [Batch : %f] [Speedup : %.2fx]"),
+		*UEnum::GetValueAsString(MapType), Width, Height, Requests.Num(), FTaskGraphInterface::Get().GetNumWorkerThreads() + 1,
+		SerialFound, BatchFound, (float)SerialTime, (float)BatchTime, (float)(SerialTime / FMath::Max(BatchTime, 1e-9)));
+}
+
+void APathFinder::RunMovingAIScenarios()
+{
+	TArray<FJPSMovingAIScenario> Scenarios;
+	if (!FJPSMovingAI::LoadScenarios(MovingAIScenarioPath, Scenarios))
+	{
+		return;
+	}
+
+	const FString MapPath = MovingAIMapPath.IsEmpty() ? FJPSMovingAI::ResolveMapPath(MovingAIScenarioPath, Scenarios[0]) : MovingAIMapPath;
+	FJPSMovingAIMap Map;
+	if (!FJPSMovingAI::LoadMap(MapPath, Map))
+	{
+		return;
 	}
+	ApplyMovingAIMap(Map);
+
+	// 결과 종류별 개수, EJPSScenarioCheck 순서
+	int32 JPSChecks[4] = {};
+	int32 AStarChecks[4] = {};
+	double JPSScenarioTime = 0.0;
+	double AStarScenarioTime = 0.0;
+	TArray<FIntPoint> PathResults;
+	// 같은 문제가 여러 번 나와도 매번 탐색한 시간을 잰다
+	const int32 PrevPathCacheCapacity = IsValid(JPSCollision) ? JPSCollision->PathCacheCapacity : 0;
+	if (IsValid(JPSCollision))
+	{
+		JPSCollision->ResetPathCache();
+		JPSCollision->PathCacheCapacity = 0;
+	}
+	for (const FJPSMovingAIScenario& Scenario : Scenarios)
+	{
+		if (Scenario.MapWidth != Map.Width || Scenario.MapHeight != Map.Height)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Skip scenario for %s (%d x %d)"), *Scenario.MapName, Scenario.MapWidth, Scenario.MapHeight);
+			continue;
+		}
+
+		if (IsValid(JPSCollision))
+		{
+			PathResults.Reset();
+			{
+				FDurationTimer JPSTimer(JPSScenarioTime);
+				JPSCollision->FindPath(Scenario.Start, Scenario.Goal, PathResults);
+				JPSTimer.Stop();
+			}
+			// 시작과 목적지가 같은 문제는 빈 경로가 정답이다
+			const bool Found = PathResults.Num() > 0 || Scenario.Start == Scenario.Goal;
+			const EJPSScenarioCheck Check = FJPSMovingAI::CheckPath(Scenario, Found, FJPSMovingAI::GetPathLength(Scenario.Start, PathResults));
+			JPSChecks[static_cast<int32>(Check)]++;
+			if (Check == EJPSScenarioCheck::Longer || Check == EJPSScenarioCheck::NotFound)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("JPS Scenario [Bucket = %d] (%d, %d) -> (%d, %d) [Optimal : %f] [Length : %f]"),
+					Scenario.Bucket, Scenario.Start.X, Scenario.Start.Y, Scenario.Goal.X, Scenario.Goal.Y, Scenario.OptimalLength, FJPSMovingAI::GetPathLength(Scenario.Start, PathResults));
+			}
+		}
+
+		if (IsValid(AStarCollision))
+		{
+			FGraph PathFinder(*AStarCollision);
+			FGridQueryFilter GridQueryFilter;
+			TArray<AAStarCollision::FNodeRef> OutPath;
+			EGraphAStarResult Result;
+			{
+				FDurationTimer AStarTimer(AStarScenarioTime);
+				Result = PathFinder.FindPath(FSearchNode(Scenario.Start), FSearchNode(Scenario.Goal), GridQueryFilter, OutPath);
+				AStarTimer.Stop();
+			}
+			const EJPSScenarioCheck Check = FJPSMovingAI::CheckPath(Scenario, Result == EGraphAStarResult::SearchSuccess, FJPSMovingAI::GetPathLength(Scenario.Start, OutPath));
+			AStarChecks[static_cast<int32>(Check)]++;
+		}
+	}
+	if (IsValid(JPSCollision))
+	{
+		JPSCollision->PathCacheCapacity = PrevPathCacheCapacity;
+	}
+
+	// 모서리를 끼고 도는 대각선 이동을 허용하기 때문에 Shorter는 정상이고 Longer나 NotFound가 있으면 탐색이 틀린 것이다
+	UE_LOG(LogTemp, Log, TEXT("MovingAI [%s] [Scenarios = %d] [MapSize = %d x %d]"), *FPaths::GetCleanFilename(MapPath), Scenarios.Num(), Map.Width, Map.Height);
+	UE_LOG(LogTemp, Log, TEXT("JPS   [Optimal : %d] [Shorter : %d] [Longer : %d] [NotFound : %d] [Total Time : %f]"), JPSChecks[0], JPSChecks[1], JPSChecks[2], JPSChecks[3], (float)JPSScenarioTime);
+	UE_LOG(LogTemp, Log, TEXT("AStar [Optimal : %d] [Shorter : %d] [Longer : %d] [NotFound : %d] [Total Time : %f]"), AStarChecks[0], AStarChecks[1], AStarChecks[2], AStarChecks[3], (float)AStarScenarioTime);
+}
+
+void APathFinder::ApplyMovingAIMap(const FJPSMovingAIMap& InMap)
+{
+	Width = InMap.Width;
+	Height = InMap.Height;
+
+	CreateCollisionMaps();
+	ApplyBitmap(InMap.Bitmap, InMap.WordWidths);
 
-	UE_LOG(LogTemp, Log, TEXT("AStar PathFinding [Test Count = %d] [TestMapSize = %d x %d] [Average Time : %f]"), PathFindingSimulateCount, Width, Height, (float)(AStarTime / AStarCount));
-	UE_LOG(LogTemp, Log, TEXT("JPS PathFinding   [Test Count = %d] [TestMapSize = %d x %d] [Average Time : %f]"), PathFindingSimulateCount, Width, Height, (float)(JPSTime / JPSCount));
+	// 정적 맵이므로 InitData와 같이 다 채운 다음 전처리한다
+	BuildPrecomputedData();
 }
 
 FVector APathFinder::GetNodeLocation(int32 InX, int32 InY, bool InCheckNavmesh)
@@ -493,7 +1015,7 @@ bool APathFinder::OverlapsMyBox(const FMyBox& InBoxA, const FMyBox& InBoxB)
 	return true;
 }
 
-TArray<TArray<uint8>> APathFinder::GenerateMaze(int32 InMapSize)
+TArray<TArray<uint8>> APathFinder::GenerateMaze(int32 InMapSize, int32 InSeed)
 {
 	int32 GenerateMapSize = (InMapSize - 1) / 2;
 	// 최종 격자 크기는 2N+1
@@ -515,7 +1037,7 @@ TArray<TArray<uint8>> APathFinder::GenerateMaze(int32 InMapSize)
 		visited[y].Init(false, GenerateMapSize);
 	}
 
-	std::srand((unsigned)std::time(nullptr));
+	FRandomStream RandomStream(InSeed);
 
 	// (0,0) 셀(실제 좌표 (1,1))을 시작점
 	visited[0][0] = true;
@@ -554,7 +1076,7 @@ TArray<TArray<uint8>> APathFinder::GenerateMaze(int32 InMapSize)
 
 		if (!candidates.IsEmpty())
 		{
-			int32 dir = candidates[rand() % candidates.Num()];
+			int32 dir = candidates[RandomStream.RandHelper(candidates.Num())];
 			int32 ny = cy + DY[dir];
 			int32 nx = cx + DX[dir];
 
@@ -588,7 +1110,7 @@ TArray<TArray<uint8>> APathFinder::GenerateMaze(int32 InMapSize)
 	return maze;
 }
 
-TArray<TArray<uint8>> APathFinder::GenerateRoomsMap(int32 InMapSize)
+TArray<TArray<uint8>> APathFinder::GenerateRoomsMap(int32 InMapSize, int32 InSeed)
 {
 	// 맵 전체를 1(벽)으로 초기화
 	TArray<TArray<uint8>> Map;
@@ -598,7 +1120,7 @@ TArray<TArray<uint8>> APathFinder::GenerateRoomsMap(int32 InMapSize)
 		Map[i].Init(1, Width);
 	}
 
-	FRandomStream RandomStream(FMath::RandRange(0,9999));
+	FRandomStream RandomStream(InSeed);
 
 	// (1) 방 생성
 	TArray<FMyBox> Rooms;
@@ -607,7 +1129,7 @@ TArray<TArray<uint8>> APathFinder::GenerateRoomsMap(int32 InMapSize)
 
 	int32 MinRoomCount = InMapSize / 10 > 2 ? InMapSize / 10 : 2;
 	int32 MaxRoomCount = InMapSize / 5 > 5 && InMapSize / 5 > MinRoomCount ? InMapSize / 5 : MinRoomCount + 3;
-	int32 RoomCount = FMath::RandRange(MinRoomCount, 5);
+	int32 RoomCount = RandomStream.RandRange(MinRoomCount, 5);
 
 	int32 MinRoomSize = InMapSize / 10;
 	int32 MaxRoomSize = InMapSize / 4;
@@ -700,7 +1222,7 @@ TArray<TArray<uint8>> APathFinder::GenerateRoomsMap(int32 InMapSize)
 	return Map;
 }
 
-TArray<TArray<uint8>> APathFinder::GenerateBlock(int32 InMapSize)
+TArray<TArray<uint8>> APathFinder::GenerateBlock(int32 InMapSize, int32 InSeed)
 {
 	// 맵 전체를 통로(0)로 초기화
 	TArray<TArray<uint8>> Map;
@@ -710,7 +1232,7 @@ TArray<TArray<uint8>> APathFinder::GenerateBlock(int32 InMapSize)
 		Map[i].Init(0, InMapSize);
 	}
 
-	FRandomStream RandomStream(FMath::RandRange(0, 9999));
+	FRandomStream RandomStream(InSeed);
 
 	int32 Placed = 0;
 	int32 Attempts = 0;
@@ -718,7 +1240,7 @@ TArray<TArray<uint8>> APathFinder::GenerateBlock(int32 InMapSize)
 
 	int32 MinBlockCount = InMapSize / 10 > 2 ? InMapSize / 10 : 2;
 	int32 MaxBlockCount = InMapSize / 5 > 5 && InMapSize / 5 > MinBlockCount ? InMapSize / 5 : MinBlockCount + 3;
-	int32 BlockCount = FMath::RandRange(MinBlockCount, MaxBlockCount);
+	int32 BlockCount = RandomStream.RandRange(MinBlockCount, MaxBlockCount);
 
 	int32 MinRoomScale = InMapSize / 10;
 	int32 MaxRoomScale = InMapSize / 5;
@@ -5,6 +5,8 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "GraphAStar.h"
+#include "JPSGrid.h"
+#include "JPSNeighbourMasks.h"
 
 #include "AStarCollision.generated.h"
 
@@ -21,55 +23,100 @@ public:
 
 	int32 Width;
 	int32 Height;
-	TArray<bool> NodeAccessibility;
+
+	// 직접 만든 맵, 1이면 충돌지점, 다른 맵을 공유하는 동안에는 비어있다
+	FJPSGrid OwnedGrid;
+	// 탐색이 읽는 맵, OwnedGrid나 AJPSCollision이 가진 비트배열의 뷰
+	FJPSGridView Grid;
+	bool bSharingGrid = false;
+
+	// 맵을 다 채운 다음 칸마다 이동 가능한 이웃 마스크를 만들어서 유효한 이웃만 탐색에 넘긴다
+	UPROPERTY(EditAnywhere, Category = "AStarArea")
+	bool bUseNeighbourMasks = false;
+	// 비어있으면 8방향을 모두 넘기고 IsValidRef로 거른다
+	FJPSNeighbourMasks NeighbourMasks;
+
+	// 현재 맵으로 이웃 마스크를 만든다, 공유한 맵이 바뀌면 맵을 바꾼 쪽에서 UpdateNeighbourMasks로 고쳐야 한다
+	bool BuildNeighbourMasks() { return NeighbourMasks.Build(Grid); }
+	// 맵의 일부가 바뀐 뒤 그 영역의 마스크만 고친다, 마스크가 없으면 아무것도 하지 않는다
+	void UpdateNeighbourMasks(TConstArrayView<FIntRect> InDirtyRects)
+	{
+		for (const FIntRect& Rect : InDirtyRects)
+		{
+			NeighbourMasks.Update(Grid, Rect);
+		}
+	}
+	void ResetNeighbourMasks() { NeighbourMasks.Reset(); }
 
 	void BuildMap(int32 InWidth, int32 InHeight)
 	{
-		NodeAccessibility.Empty();
 		Width = InWidth;
 		Height = InHeight;
-		NodeAccessibility.Init(true, Width * Height);
+		OwnedGrid.Create(Width, Height);
+		Grid = OwnedGrid.GetView();
+		bSharingGrid = false;
+		NeighbourMasks.Reset();
 	}
+
+	// 다른 액터의 비트배열을 복사 없이 읽는다, 그 맵을 다시 만들면 새 뷰로 다시 호출해야 한다
+	void ShareGrid(const FJPSGridView& InGrid)
+	{
+		OwnedGrid = FJPSGrid();
+		Grid = InGrid;
+		bSharingGrid = true;
+		NeighbourMasks.Reset();
+		Width = Grid.GetWidth();
+		Height = Grid.GetHeight();
+	}
+	// 공유한 맵은 주인이 수정하므로 SetNodeAccessibility와 ApplyBitmap은 무시된다
+	bool IsSharingGrid() const { return bSharingGrid; }
+
 	// FGraphAStar: TGraph interface
 	typedef FGridNodeRef FNodeRef; //= FIntPoint
 	int32 GetNeighbourCount(FNodeRef NodeRef) const
 	{
-		return 8;
+		return NeighbourMasks.IsValid() ? FMath::CountBits(NeighbourMasks.Get(NodeRef.X, NodeRef.Y)) : 8;
 	}
 
 	bool IsValidRef(FNodeRef NodeRef) const
 	{
-		if (NodeRef.X >= 0 && NodeRef.X < Width && NodeRef.Y >= 0 && NodeRef.Y < Height && IsNodeAccessible(NodeRef))
-		{
-			return true;
-		}
-		return false;
+		// 맵 밖도 충돌지점이라 비트 하나만 검사한다
+		return IsNodeAccessible(NodeRef);
 	}
 
 	// 노드의 이동 가능 여부 확인
 	bool IsNodeAccessible(FNodeRef NodeRef) const
 	{
-		int32 Index = NodeRef.Y * Width + NodeRef.X;
+		return !Grid.IsCollision(NodeRef.X, NodeRef.Y);
+	}
 
-		if (NodeAccessibility.IsValidIndex(Index))
+	// 노드의 이동 가능 여부 설정
+	void SetNodeAccessibility(int32 InX, int32 InY, bool bAccessible)
+	{
+		if (!IsSharingGrid() && OwnedGrid.SetAt(InX, InY, !bAccessible))
 		{
-			return NodeAccessibility[Index];
+			NeighbourMasks.Reset();
 		}
-		return false;
 	}
 
-	// 노드의 이동 가능 여부 설정
-	void SetNodeAccessibility(int32 InX, int32 InY, bool bAccessible)
+	// 행 우선 비트버퍼(한 행에 InWordWidths개의 uint64, 1이면 충돌지점)로 맵 전체를 교체
+	void ApplyBitmap(TConstArrayView<uint64> InBitmap, int32 InWordWidths)
 	{
-		int32 Index = InY * Width + InX;
-		if (NodeAccessibility.IsValidIndex(Index))
+		if (!IsSharingGrid())
 		{
-			NodeAccessibility[Index] = bAccessible;
+			OwnedGrid.ApplyBitmap(InBitmap, InWordWidths);
+			NeighbourMasks.Reset();
 		}
 	}
 
 	FNodeRef GetNeighbour(const FSearchNode& NodeRef, const int32 NeighbourIndex) const
 	{
+		if (NeighbourMasks.IsValid())
+		{
+			const uint8 Mask = NeighbourMasks.Get(NodeRef.NodeRef.X, NodeRef.NodeRef.Y);
+			return NodeRef.NodeRef + FJPSNeighbourMasks::GetOffset(FJPSNeighbourMasks::GetNthDirection(Mask, NeighbourIndex));
+		}
+
 		static const FIntPoint Directions[] = { FIntPoint(1, 0), FIntPoint(1, -1), FIntPoint(0, -1), FIntPoint(-1, -1), FIntPoint(-1, 0), FIntPoint(-1, 1), FIntPoint(0, 1), FIntPoint(1, 1) };
 		return NodeRef.NodeRef + Directions[NeighbourIndex];
 	}
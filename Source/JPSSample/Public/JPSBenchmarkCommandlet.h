@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+
+#include "JPSBenchmarkCommandlet.generated.h"
+
+/**
+ * 월드 없이 길찾기 엔진들의 지연시간과 처리량을 측정하는 커맨드렛
+ * UnrealEditor-Cmd JPSSample.uproject -run=JPSBenchmark -Sizes=256,1024 -Densities=0.2,0.35 -Queries=2000 -Threads=1,4 -Label=<커밋>
+ * -Scenarios=a.map.scen,b.map.scen 으로 MovingAI 시나리오를 측정하고 경로 길이를 최적값과 비교한다
+ * 생성한 맵과 요청은 Saved/Benchmarks/JPSBenchmark-Corpus.bin(-Corpus로 변경, -NoCorpus로 끔)에 저장해두고 다음 실행에서 다시 읽는다
+ * 결과는 Saved/Benchmarks 아래(-Out으로 변경)에 JSON과 CSV로 남겨서 커밋끼리 비교한다
+ */
+UCLASS()
+class UJPSBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UJPSBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
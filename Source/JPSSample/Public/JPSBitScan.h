@@ -0,0 +1,206 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if PLATFORM_ALWAYS_HAS_AVX_2
+#include <immintrin.h>
+#endif
+
+// 비트배열의 한 행을 원소 단위로 검색하는 함수 모음
+// 원소를 InInvert와 xor해서 0이 아닌 원소를 찾는다 (충돌지점 검색은 0, 오픈지점 검색은 모든 비트가 1인 값)
+struct FJPSBitScan
+{
+	// 한번에 검사하는 원소 수
+	static const int32 NGROUP = 4;
+
+	// InWords[InBegin, InEnd) 에서 0이 아닌 첫 원소의 인덱스, 없다면 InEnd
+	static int32 FindForward(const uint64* InWords, int32 InBegin, int32 InEnd, uint64 InInvert)
+	{
+		int32 Word = InBegin;
+#if PLATFORM_ALWAYS_HAS_AVX_2
+		const __m256i Invert = _mm256_set1_epi64x(static_cast<long long>(InInvert));
+		for (; Word + NGROUP <= InEnd; Word += NGROUP)
+		{
+			const __m256i Value = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(InWords + Word)), Invert);
+			if (!_mm256_testz_si256(Value, Value))
+			{
+				break;
+			}
+		}
+#else
+		for (; Word + NGROUP <= InEnd; Word += NGROUP)
+		{
+			if ((InWords[Word] ^ InInvert) | (InWords[Word + 1] ^ InInvert) | (InWords[Word + 2] ^ InInvert) | (InWords[Word + 3] ^ InInvert))
+			{
+				break;
+			}
+		}
+#endif
+		// 묶음 안에서 정확한 원소를 찾거나 남은 원소를 검사
+		for (; Word < InEnd; Word++)
+		{
+			if (InWords[Word] ^ InInvert)
+			{
+				return Word;
+			}
+		}
+		return InEnd;
+	}
+
+	// InWords[0, InBegin] 을 역방향으로 검색해서 0이 아닌 첫 원소의 인덱스, 없다면 -1
+	static int32 FindBackward(const uint64* InWords, int32 InBegin, uint64 InInvert)
+	{
+		int32 Word = InBegin;
+#if PLATFORM_ALWAYS_HAS_AVX_2
+		const __m256i Invert = _mm256_set1_epi64x(static_cast<long long>(InInvert));
+		for (; Word - NGROUP + 1 >= 0; Word -= NGROUP)
+		{
+			const __m256i Value = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(InWords + Word - NGROUP + 1)), Invert);
+			if (!_mm256_testz_si256(Value, Value))
+			{
+				break;
+			}
+		}
+#else
+		for (; Word - NGROUP + 1 >= 0; Word -= NGROUP)
+		{
+			if ((InWords[Word] ^ InInvert) | (InWords[Word - 1] ^ InInvert) | (InWords[Word - 2] ^ InInvert) | (InWords[Word - 3] ^ InInvert))
+			{
+				break;
+			}
+		}
+#endif
+		for (; Word >= 0; Word--)
+		{
+			if (InWords[Word] ^ InInvert)
+			{
+				return Word;
+			}
+		}
+		return -1;
+	}
+
+	// 직선 점프포인트 검색에서 멈춰야 하는 칸, 자기 행의 충돌지점과 옆 행이 막혀있고 진행방향 다음 칸이 열린 곳
+	// InSelf[InBegin, InEnd) 에서 멈출 칸이 있는 첫 원소의 인덱스, 없다면 InEnd
+	// 옆 행의 다음 원소를 같이 읽기 때문에 InEnd 원소까지 읽을 수 있어야 한다, 맵 밖의 옆 행은 InSelf를 넘기면 결과가 같다
+	static int32 FindStopForward(const uint64* InSelf, const uint64* InSideA, const uint64* InSideB, int32 InBegin, int32 InEnd)
+	{
+		int32 Word = InBegin;
+#if PLATFORM_ALWAYS_HAS_AVX_2
+		for (; Word + NGROUP <= InEnd; Word += NGROUP)
+		{
+			const __m256i SideA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(InSideA + Word));
+			const __m256i SideB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(InSideB + Word));
+			const __m256i NextA = _mm256_or_si256(_mm256_srli_epi64(SideA, 1), _mm256_slli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(InSideA + Word + 1)), 63));
+			const __m256i NextB = _mm256_or_si256(_mm256_srli_epi64(SideB, 1), _mm256_slli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(InSideB + Word + 1)), 63));
+			const __m256i Stop = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(InSelf + Word)),
+				_mm256_or_si256(_mm256_andnot_si256(NextA, SideA), _mm256_andnot_si256(NextB, SideB)));
+			if (!_mm256_testz_si256(Stop, Stop))
+			{
+				break;
+			}
+		}
+#else
+		for (; Word + NGROUP <= InEnd; Word += NGROUP)
+		{
+			if (StopForward(InSelf, InSideA, InSideB, Word) | StopForward(InSelf, InSideA, InSideB, Word + 1)
+				| StopForward(InSelf, InSideA, InSideB, Word + 2) | StopForward(InSelf, InSideA, InSideB, Word + 3))
+			{
+				break;
+			}
+		}
+#endif
+		for (; Word < InEnd; Word++)
+		{
+			if (StopForward(InSelf, InSideA, InSideB, Word))
+			{
+				return Word;
+			}
+		}
+		return InEnd;
+	}
+
+	// FindStopForward의 역방향, InSelf[InEnd, InBegin] 을 역방향으로 검사해서 멈출 칸이 있는 첫 원소의 인덱스, 없다면 InEnd - 1
+	// 옆 행의 이전 원소를 같이 읽기 때문에 InEnd는 1 이상이어야 한다
+	static int32 FindStopBackward(const uint64* InSelf, const uint64* InSideA, const uint64* InSideB, int32 InBegin, int32 InEnd)
+	{
+		int32 Word = InBegin;
+#if PLATFORM_ALWAYS_HAS_AVX_2
+		for (; Word - NGROUP + 1 >= InEnd; Word -= NGROUP)
+		{
+			const int32 First = Word - NGROUP + 1;
+			const __m256i SideA = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(InSideA + First));
+			const __m256i SideB = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(InSideB + First));
+			const __m256i NextA = _mm256_or_si256(_mm256_slli_epi64(SideA, 1), _mm256_srli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(InSideA + First - 1)), 63));
+			const __m256i NextB = _mm256_or_si256(_mm256_slli_epi64(SideB, 1), _mm256_srli_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(InSideB + First - 1)), 63));
+			const __m256i Stop = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(InSelf + First)),
+				_mm256_or_si256(_mm256_andnot_si256(NextA, SideA), _mm256_andnot_si256(NextB, SideB)));
+			if (!_mm256_testz_si256(Stop, Stop))
+			{
+				break;
+			}
+		}
+#else
+		for (; Word - NGROUP + 1 >= InEnd; Word -= NGROUP)
+		{
+			if (StopBackward(InSelf, InSideA, InSideB, Word) | StopBackward(InSelf, InSideA, InSideB, Word - 1)
+				| StopBackward(InSelf, InSideA, InSideB, Word - 2) | StopBackward(InSelf, InSideA, InSideB, Word - 3))
+			{
+				break;
+			}
+		}
+#endif
+		for (; Word >= InEnd; Word--)
+		{
+			if (StopBackward(InSelf, InSideA, InSideB, Word))
+			{
+				return Word;
+			}
+		}
+		return InEnd - 1;
+	}
+
+	// 한 원소의 멈출 칸, 옆 행의 막힌 칸 중 진행방향 다음 칸이 열린 곳
+	static uint64 StopForward(const uint64* InSelf, const uint64* InSideA, const uint64* InSideB, int32 InWord)
+	{
+		const uint64 NextA = (InSideA[InWord] >> 1) | (InSideA[InWord + 1] << 63);
+		const uint64 NextB = (InSideB[InWord] >> 1) | (InSideB[InWord + 1] << 63);
+		return InSelf[InWord] | (InSideA[InWord] & ~NextA) | (InSideB[InWord] & ~NextB);
+	}
+	static uint64 StopBackward(const uint64* InSelf, const uint64* InSideA, const uint64* InSideB, int32 InWord)
+	{
+		const uint64 NextA = (InSideA[InWord] << 1) | (InSideA[InWord - 1] >> 63);
+		const uint64 NextB = (InSideB[InWord] << 1) | (InSideB[InWord - 1] >> 63);
+		return InSelf[InWord] | (InSideA[InWord] & ~NextA) | (InSideB[InWord] & ~NextB);
+	}
+
+	// 64x64 비트 행렬을 전치한다, InOutBlock[i]의 j번 비트가 InOutBlock[j]의 i번 비트로 간다
+	// 절반 크기의 블록끼리 교환하는 과정을 32, 16, ... 1 크기로 반복
+	static void Transpose64(uint64* InOutBlock)
+	{
+		uint64 Mask = 0x00000000FFFFFFFFULL;
+		for (int32 Size = 32; Size != 0; Size >>= 1, Mask ^= Mask << Size)
+		{
+			for (int32 Row = 0; Row < 64; Row = ((Row | Size) + 1) & ~Size)
+			{
+				const uint64 Swap = ((InOutBlock[Row] >> Size) ^ InOutBlock[Row | Size]) & Mask;
+				InOutBlock[Row | Size] ^= Swap;
+				InOutBlock[Row] ^= Swap << Size;
+			}
+		}
+	}
+
+	// [InBegin, InEnd) 비트가 1인 마스크 (0 <= InBegin < InEnd <= 64)
+	static uint64 RangeMask(int32 InBegin, int32 InEnd)
+	{
+		const uint64 EndMask = (InEnd >= 64) ? ~0ULL : ((1ULL << InEnd) - 1);
+		return EndMask & (~0ULL << InBegin);
+	}
+
+	// 가장 낮은 1비트의 인덱스 (InWord != 0)
+	static int32 LowestBit(uint64 InWord) { return static_cast<int32>(FMath::CountTrailingZeros64(InWord)); }
+	// 가장 높은 1비트의 인덱스 (InWord != 0)
+	static int32 HighestBit(uint64 InWord) { return 63 - static_cast<int32>(FMath::CountLeadingZeros64(InWord)); }
+};
@@ -3,13 +3,69 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Async/Future.h"
+
+#include <atomic>
 
-#include "TDBitArray.h"
 #include "JPSCore.h"
+#include "JPSGrid.h"
+#include "JPSPathCache.h"
 
 #include "JPSCollision.generated.h"
 
 class UJPSPath;
+struct FJPSSearchContext;
+
+// 비동기 탐색 요청을 구분하는 핸들, Id가 0이면 유효하지 않다
+struct FJPSPathHandle
+{
+	uint32 Id = 0;
+
+	bool IsValid() const { return Id != 0; }
+	bool operator==(const FJPSPathHandle& InRhs) const { return Id == InRhs.Id; }
+	bool operator!=(const FJPSPathHandle& InRhs) const { return Id != InRhs.Id; }
+	friend uint32 GetTypeHash(const FJPSPathHandle& InHandle) { return InHandle.Id; }
+};
+
+// 비동기 탐색 완료 알림, 게임 스레드에서 호출된다
+DECLARE_DELEGATE_TwoParams(FOnJPSPathComplete, FJPSPathHandle, const FPathResult&);
+
+// 맵 버전 하나에서 바뀐 영역
+struct FJPSMapChange
+{
+	uint32 Version = 0;
+	// 바뀐 칸을 덮는 사각형(Max는 포함하지 않는다), 겹치거나 맞닿은 사각형은 하나로 합쳐서 보관한다
+	TArray<FIntRect> DirtyRects;
+	// 맵을 새로 만들었거나 통째로 교체했다, 이전에 받은 뷰와 맵으로 만든 데이터를 모두 다시 만들어야 한다
+	bool bFullRebuild = false;
+
+	void AddDirtyRect(const FIntRect& InRect);
+	void Append(const FJPSMapChange& InChange);
+};
+
+// 맵 버전이 바뀔 때 게임 스레드에서 호출된다
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnJPSMapChanged, const FJPSMapChange&);
+
+// 대기중이거나 실행중인 비동기 탐색 요청
+struct FJPSAsyncPathRequest
+{
+	FJPSPathHandle Handle;
+	// 클수록 먼저 실행된다
+	int32 Priority = 0;
+	FPathRequest Request;
+	FOnJPSPathComplete OnComplete;
+	// TFuture로 요청한 경우의 결과 전달, 취소되어도 빈 결과로 채운다
+	TSharedPtr<TPromise<FPathResult>> Promise;
+	// 실행중일 때 빌린 컨텍스트와 작업
+	FJPSSearchContext* Context = nullptr;
+	TFuture<void> Task;
+	// 워커가 탐색 단계마다 확인하는 중단 요청, 취소하거나 맵을 바꿀 때 켠다
+	TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> StopFlag;
+	// 실행을 시작할 때의 맵 버전, 결과를 알릴 때 달라졌으면 다시 탐색한다
+	uint32 MapVersion = 0;
+	// 결과를 버린다, 게임 스레드에서만 접근한다
+	bool bCancelled = false;
+};
 
 UCLASS()
 class AJPSCollision : public AActor
@@ -20,6 +76,8 @@ public:
 	AJPSCollision();
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void BeginDestroy() override;
 public:
 	bool CreateMap();
 
@@ -28,24 +86,85 @@ public:
 	void SetWidth(const int32& InWidth) { Width = InWidth; }
 	void SetHeight(const int32& InHeight) { Height = InHeight; }
 	bool IsOutBound(int32 InX, int32 InY) const;
-	bool IsCollision(int32 InX, int32 InY);
+	bool IsCollision(int32 InX, int32 InY) const;
 
 	void SetAt(int32 InX, int32 InY);
 	void ClearAt(int32 InX, int32 InY);
 
-	int32 GetCloseValue(int32 InX, int32 InY, bool IsXaxis, bool IsForward);
-	int32 GetOpenValue(int32 InX, int32 InY, bool IsXaxis, bool IsForward);
+	// 사각형 영역을 한번에 충돌지점으로 설정하거나 해제
+	void SetRect(int32 InX, int32 InY, int32 InWidth, int32 InHeight);
+	void ClearRect(int32 InX, int32 InY, int32 InWidth, int32 InHeight);
+	// 행 우선 비트버퍼(한 행에 InWordWidths개의 uint64, 1이면 충돌지점)로 맵 전체를 교체
+	bool ApplyBitmap(TConstArrayView<uint64> InBitmap, int32 InWordWidths);
+	// ApplyBitmap에 넘길 비트버퍼의 한 행 원소 수
+	int32 GetBitmapWordWidths() const { return BitGrid.GetBitmapWordWidths(); }
+	// 액터와 무관한 비트배열 맵, 탐색과 전처리는 이 맵의 뷰로 동작한다
+	const FJPSGrid& GetGrid() const { return BitGrid; }
+	FJPSGridView GetGridView() const { return BitGrid.GetView(); }
 
 	void BuildMap();
-
+	void SetOpenListType(EJPSOpenListType InType);
+	// 현재 맵으로 JPS+ 테이블을 만든다, SetAt과 ClearAt은 테이블을 고쳐서 유지하고
+	// 맵 생성과 영역 단위 수정은 테이블을 버려서 비트 검색으로 돌아간다
+	bool BuildJPSPlus();
+	// 현재 맵으로 목적지 경계 상자를 만든다, 맵을 바꾸면 버려진다
+	bool BuildGoalBounds();
+
+	// 경로 캐시에 같은 시작/목적지 쌍(뒤집은 쌍 포함)이 있으면 탐색하지 않고 돌려준다
 	void FindPath(FIntPoint InStartCoord, FIntPoint InEndCoord, TArray<FIntPoint>& OutResultPos);
+	// 마지막으로 실제 탐색한 FindPath의 작업량, 캐시에서 찾은 요청은 바꾸지 않는다
+	FJPSSearchStats GetLastSearchStats() const;
+	const FJPSPathCacheStats& GetPathCacheStats() const { return PathCache.GetStats(); }
+	void ResetPathCache() { PathCache.Reset(); }
+	// 맵을 바꿀 때마다 증가한다, BeginMapEdit와 EndMapEdit 사이의 수정은 한 버전으로 묶인다
+	uint32 GetMapVersion() const { return MapVersion; }
+	// 여러 칸을 바꾸는 동안 변경 알림을 모아서 EndMapEdit에서 한 번만 보낸다, 중첩할 수 있다
+	void BeginMapEdit();
+	void EndMapEdit();
+	// InVersion 다음부터 현재 버전까지 바뀐 영역을 합친다
+	// 기록이 남아있지 않을 만큼 오래된 버전이면 bFullRebuild로 채우고 false
+	bool GetChangesSince(uint32 InVersion, FJPSMapChange& OutChange) const;
+	// 맵을 다시 만들거나 칸을 바꾸면 새 버전과 바뀐 영역을 알린다
+	FOnJPSMapChanged& OnMapChanged() { return MapChanged; }
+	// 여러 요청을 워커 스레드에서 동시에 탐색, 끝날 때까지 맵을 바꾸지 않아야 한다
+	void FindPathBatch(TConstArrayView<FPathRequest> InRequests, TArrayView<FPathResult> OutResults);
+
+	// 백그라운드 스레드에서 탐색하고 게임 스레드에서 결과를 알린다, 우선순위가 높은 요청부터 실행한다
+	// 알리기 전에 맵이 바뀐 결과는 버리고 다시 탐색하므로 결과는 항상 현재 맵 버전이다
+	FJPSPathHandle RequestPathAsync(FIntPoint InStartCoord, FIntPoint InEndCoord, FOnJPSPathComplete InOnComplete, int32 InPriority = 0);
+	TFuture<FPathResult> RequestPathFuture(FIntPoint InStartCoord, FIntPoint InEndCoord, int32 InPriority = 0, FJPSPathHandle* OutHandle = nullptr);
+	// 대기중인 요청은 바로 제거하고 실행중인 요청은 다음 단계에서 멈추고 결과를 버린다, 취소된 요청의 델리게이트는 호출되지 않는다
+	bool CancelPath(FJPSPathHandle InHandle);
+	void CancelAllPaths();
+	bool IsPathPending(FJPSPathHandle InHandle) const;
+	// 실행중인 비동기 탐색의 워커가 끝날 때까지 기다린다
+	void WaitForAsyncPaths();
 
 private:
-	int32 GetPosX(int32 InX, int32 InY);
-	int32 GetPosY(int32 InX, int32 InY);
-
-	static bool BitScanReverse64(unsigned long& InIndex, uint64 InWord);
-	static bool BitScanForward64(unsigned long& InIndex, uint64 InWord);
+	// 맵을 바꾸기 전에 실행중인 탐색을 멈추고 맵에서 만든 테이블과 경계 상자를 버린다
+	void BeginMapWrite();
+	// 한 칸을 바꾸고 JPS+ 테이블이 있으면 그 주변만 고친다, 경계 상자는 버린다
+	void WriteCell(int32 InX, int32 InY, bool InFlag);
+	// 진행중인 변경이 없으면 새 버전으로 시작한다
+	void OpenMapChange();
+	// 바뀐 영역을 현재 수정의 버전에 기록하고 그 영역을 지나는 캐시 경로를 버린다, 수정 중이 아니면 바로 알린다
+	void MarkDirty(const FIntRect& InRect, bool InBlocked);
+	// 맵 전체가 바뀌었다
+	void MarkFullRebuild();
+	// 모아둔 변경을 기록에 남기고 알린다
+	void CommitMapChange();
+
+	FJPSPathHandle EnqueuePath(FIntPoint InStartCoord, FIntPoint InEndCoord, int32 InPriority, FOnJPSPathComplete&& InOnComplete, TSharedPtr<TPromise<FPathResult>>&& InPromise);
+	// 실행 슬롯이 남아있는 만큼 대기열에서 꺼내서 실행
+	void DispatchAsyncPaths();
+	// 실행중인 탐색을 다음 단계에서 멈추게 하고 워커가 끝날 때까지 기다린다, 멈춘 탐색은 완료 알림에서 다시 대기열에 넣는다
+	void StopAsyncPaths();
+	// InStopped면 탐색이 끝나기 전에 멈췄다
+	void OnAsyncPathFinished(uint32 InId, bool InStopped, FPathResult&& InResult);
+	// 워커가 모두 끝난 뒤 남은 실행중 요청을 빈 결과로 끝내고 컨텍스트를 돌려준다
+	void DrainAsyncPaths();
+
+	void FillRect(int32 InX, int32 InY, int32 InWidth, int32 InHeight, bool InFlag);
 
 public:
 	// 2D 그리드의 너비
@@ -54,15 +173,45 @@ public:
 	// 2D 그리드의 높이
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "JPSArea")
 	int32 Height;
+	// 오픈리스트 구현
+	UPROPERTY(EditAnywhere, Category = "JPSArea")
+	EJPSOpenListType OpenListType;
+	// 정적 맵에서 JPS+ 점프 거리 테이블로 탐색
+	UPROPERTY(EditAnywhere, Category = "JPSArea")
+	bool bUseJPSPlus;
+	// 정적 맵에서 목적지 경계 상자로 확장할 방향을 줄인다, 칸 수의 제곱에 비례하는 전처리가 필요하다
+	UPROPERTY(EditAnywhere, Category = "JPSArea")
+	bool bUseGoalBounds;
+	// 동시에 실행하는 비동기 탐색 수
+	UPROPERTY(EditAnywhere, Category = "JPSArea")
+	int32 MaxAsyncPathTasks;
+	// 비동기 탐색이 취소나 맵 변경을 확인하는 간격(확장 노드 수), 맵을 바꾸는 쪽은 최대 이만큼만 기다린다
+	UPROPERTY(EditAnywhere, Category = "JPSArea", meta = (ClampMin = "1"))
+	int32 AsyncPathStepExpansions;
+	// FindPath 결과를 저장해두는 경로 수, 0이면 캐시하지 않는다
+	UPROPERTY(EditAnywhere, Category = "JPSArea", meta = (ClampMin = "0"))
+	int32 PathCacheCapacity;
 
 private:
-	static const int64 NPos = ~(0);	//	default npos == -1
-
-	// X방향의 2차원 비트배열
-	TDBitArray<int64> XBoundaryPoints;
-	// Y방향의 2차원 비트배열
-	TDBitArray<int64> YBoundaryPoints;
-	// 서로 다른 2차원 비트배열을 쓰는 이유는 비트 접근은 가로방향(메모리 연속) 으로만 할 수 있기 때문에 서로 대칭되는 비트배열 2가지를 사용한다
+	// X방향과 Y방향 2차원 비트배열
+	FJPSGrid BitGrid;
+	uint32 MapVersion = 0;
+	// 알리기 전의 변경
+	FJPSMapChange PendingChange;
+	bool bPendingChange = false;
+	int32 MapEditDepth = 0;
+	// 최근 버전들의 변경, GetChangesSince가 읽는다
+	TArray<FJPSMapChange> ChangeHistory;
+	static const int32 MaxChangeHistory = 64;
+	FOnJPSMapChanged MapChanged;
+	// FindPath 결과 캐시, 칸 단위 수정은 영향을 받는 경로만 버리고 맵 전체를 바꾸면 비운다
+	FJPSPathCache PathCache;
+
+	// 우선순위 힙으로 관리하는 대기 요청
+	TArray<FJPSAsyncPathRequest> PendingPaths;
+	// 실행중인 요청, 게임 스레드에서만 접근한다
+	TMap<uint32, FJPSAsyncPathRequest> RunningPaths;
+	uint32 LastPathId = 0;
 
 public:
 	UPROPERTY()
@@ -21,7 +21,7 @@ public:
 	bool operator ==(const JPSCoord& InCoord) const { return ((InCoord.X == X) && (InCoord.Y == Y)); }
 	bool operator !=(const JPSCoord& InCoord) const { return !(*this == InCoord); }
 
-	float GetOctileDistance(const JPSCoord& InRhs)
+	float GetOctileDistance(const JPSCoord& InRhs) const
 	{
 		// 그리드안에서의 8방향 이동이기때문에 정확한 거리 코스트 계산을 위해 octile distance를 사용한다
 		int32 AbsX = FMath::Abs(X - InRhs.X);
@@ -38,7 +38,8 @@ struct FJPSNode
 {
 	GENERATED_BODY()
 
-	TSharedPtr<FJPSNode> Parent = nullptr;
+	int32 Parent = INDEX_NONE;	// 노드 아레나 안에서의 부모 인덱스
+	int32 HeapIndex = INDEX_NONE;	// 오픈리스트 안에서의 위치, 오픈리스트에 없으면 INDEX_NONE
 	JPSCoord Pos;				// Compare Same Position
 	char CardinalDir = 0;		// 이동방향
 	float Score = 0.0f;			// 시작노드부터 현재 노드까지의 이동비용
@@ -49,7 +50,8 @@ public:
 
 	void Clear()
 	{
-		Parent.Reset();
+		Parent = INDEX_NONE;
+		HeapIndex = INDEX_NONE;
 		Pos.Clear();
 		CardinalDir = 0;
 		Score = 0.0f;
@@ -57,14 +59,15 @@ public:
 		Total = 0.0f;
 	}
 
-	void Set(TSharedPtr<FJPSNode> InParent, const JPSCoord& InPos, const JPSCoord& InEnd, const char InCardinalDir)
+	void Set(int32 InParent, const FJPSNode* InParentNode, const JPSCoord& InPos, const JPSCoord& InEnd, const char InCardinalDir)
 	{
 		Parent = InParent;
+		HeapIndex = INDEX_NONE;
 		Pos = InPos;
 		CardinalDir = InCardinalDir;
-		if (Parent.IsValid())
+		if (InParentNode)
 		{
-			Score = Pos.GetOctileDistance(Parent->Pos) + Parent->Score;
+			Score = Pos.GetOctileDistance(InParentNode->Pos) + InParentNode->Score;
 		}
 		else
 		{
@@ -75,91 +78,268 @@ public:
 	}
 };
 
-UCLASS()
-class UJPSHeap : public UObject
+// 탐색 한 번 동안 생성되는 노드를 연속된 배열에 담는다
+// 노드끼리는 포인터 대신 인덱스로 연결되기 때문에 노드마다 힙 할당이나 참조 카운트가 없다
+struct FJPSNodeArena
 {
-	GENERATED_BODY()
 private:
-	TArray<TSharedPtr<FJPSNode>> Heap;
+	TArray<FJPSNode> Nodes;
+
+public:
+
+	int32 Add(int32 InParent, const JPSCoord& InPos, const JPSCoord& InEnd, const char InCardinalDir)
+	{
+		// 배열이 재할당될 수 있기 때문에 부모 노드는 추가한 다음에 참조한다
+		int32 Index = Nodes.AddUninitialized();
+		const FJPSNode* ParentNode = (InParent != INDEX_NONE) ? &Nodes[InParent] : nullptr;
+		Nodes[Index].Set(InParent, ParentNode, InPos, InEnd, InCardinalDir);
+		return Index;
+	}
+
+	FJPSNode& operator[](int32 InIndex) { return Nodes[InIndex]; }
+	const FJPSNode& operator[](int32 InIndex) const { return Nodes[InIndex]; }
+
+	int32 Num() const { return Nodes.Num(); }
+	SIZE_T GetAllocatedSize() const { return Nodes.GetAllocatedSize(); }
+	// 할당된 용량은 유지한 채 노드 수만 0으로 되돌린다
+	void Reset() { Nodes.Reset(); }
+};
+
+// 탐색 요청
+struct FPathRequest
+{
+	FIntPoint Start = FIntPoint(-1, -1);
+	FIntPoint End = FIntPoint(-1, -1);
+};
+
+// 탐색 결과, 일괄 탐색에서는 요청과 같은 순서로 채워진다
+struct FPathResult
+{
+	bool bFound = false;
+	TArray<FIntPoint> Path;
+	// 탐색한 맵 버전, AJPSCollision::GetMapVersion과 비교한다
+	uint32 MapVersion = 0;
+};
+
+// 나눠서 실행하는 탐색의 진행 상태
+UENUM()
+enum class EJPSSearchStatus : uint8
+{
+	InProgress	UMETA(DisplayName = "In Progress"),
+	Found		UMETA(DisplayName = "Found"),
+	Failed		UMETA(DisplayName = "Failed"),
+};
+
+// 탐색 한 단계에 쓸 수 있는 예산, 0 이하인 항목은 제한하지 않는다
+struct FJPSSearchBudget
+{
+	// 오픈리스트에서 꺼내서 확장하는 노드 수
+	int32 MaxExpansions = 0;
+	// 경과 시간(마이크로초)
+	double MaxMicroseconds = 0.0;
+};
+
+// 비트 검색 안쪽의 카운터를 켠다, 스레드 로컬 접근이 검색마다 생기므로 Shipping에서는 끈다
+#ifndef JPS_SEARCH_STATS
+#define JPS_SEARCH_STATS (!UE_BUILD_SHIPPING)
+#endif
+
+// 탐색 한 번의 작업량
+// 지연시간이 튈 때 힙, 비트 검색, 할당 중 어느 쪽이 늘었는지 구분하는 용도
+struct FJPSSearchStats
+{
+	// 오픈리스트에서 꺼내서 확장한 노드 수
+	int32 Expansions = 0;
+	// 생성한 점프포인트 노드 수
+	int32 JumpPoints = 0;
+	// 확장한 노드에서 시작한 직선, 대각선 점프 수
+	int32 StraightJumps = 0;
+	int32 DiagonalJumps = 0;
+	// GetCloseValue, 직선 점프포인트 검색 수와 읽은 원소 수
+	int32 Scans = 0;
+	int64 WordsTouched = 0;
+	int32 HeapPushes = 0;
+	int32 HeapPops = 0;
+	// 이미 열린 좌표의 비용을 낮춘 수
+	int32 HeapDecreaseKeys = 0;
+	// 탐색 시작 때 되돌린 닫힌 노드 비트배열의 원소 수
+	int32 ClosedWordsCleared = 0;
+
+	void Reset() { *this = FJPSSearchStats(); }
+
+	// 이 스레드에서 진행중인 탐색 단계의 카운터, 탐색 밖이면 nullptr
+	static FJPSSearchStats*& GetCurrent()
+	{
+		static thread_local FJPSSearchStats* Current = nullptr;
+		return Current;
+	}
+};
+
+// 범위 안에서 맵 검색이 InStats에 기록된다
+struct FJPSSearchStatsScope
+{
+	explicit FJPSSearchStatsScope(FJPSSearchStats& InStats) : Previous(FJPSSearchStats::GetCurrent())
+	{
+		FJPSSearchStats::GetCurrent() = &InStats;
+	}
+	~FJPSSearchStatsScope()
+	{
+		FJPSSearchStats::GetCurrent() = Previous;
+	}
+
+private:
+	FJPSSearchStats* Previous;
+};
+
+#if JPS_SEARCH_STATS
+#define JPS_SEARCH_STAT_ADD(Counter, Amount) do { if (FJPSSearchStats* JPSStats = FJPSSearchStats::GetCurrent()) { JPSStats->Counter += (Amount); } } while (0)
+#else
+#define JPS_SEARCH_STAT_ADD(Counter, Amount) do { } while (0)
+#endif
+
+// 오픈리스트 원소, 비교에 쓰는 Total을 노드 인덱스 옆에 같이 두어 비교할 때 노드를 따라가지 않는다
+struct FJPSHeapEntry
+{
+	float Total = 0.0f;
+	int32 Node = INDEX_NONE;
+};
+
+UENUM()
+enum class EJPSOpenListType : uint8
+{
+	BinaryHeap	UMETA(DisplayName = "Binary Heap"),
+	RadixHeap	UMETA(DisplayName = "Radix Heap"),
+};
+
+// 오픈리스트 구현의 공통 인터페이스, 런타임에 구현을 바꿀 수 있다
+// 워커 스레드에서도 탐색 컨텍스트마다 만들 수 있도록 UObject가 아닌 일반 클래스로 둔다
+class FJPSOpenList
+{
+protected:
+	// 좌표에 해당하는 노드, 노드의 HeapIndex로 오픈리스트에 남아있는지 확인한다
+	TMap<FIntPoint, int32> CellNodes;
+	FJPSNodeArena* Arena = nullptr;
 
 public:
+	virtual ~FJPSOpenList() = default;
+
+	// 구현 종류에 맞는 오픈리스트 생성
+	static TUniquePtr<FJPSOpenList> Create(EJPSOpenListType InType);
+
+	void SetArena(FJPSNodeArena* InArena) { Arena = InArena; }
+
+	virtual EJPSOpenListType GetType() const = 0;
+	virtual void Insert(int32 InValue) = 0;
+	virtual bool InsertSmaller(int32 InValue) = 0;
+	virtual int32 PopMin() = 0;
+	virtual int32 GetCount() const = 0;
+	virtual void ClearHeap() = 0;
+	virtual SIZE_T GetAllocatedSize() const { return CellNodes.GetAllocatedSize(); }
+};
 
-	void Insert(TSharedPtr<FJPSNode> InValue)
+// 이진 힙 오픈리스트, 노드의 HeapIndex로 힙 안의 위치를 바로 찾는다
+class FJPSHeap : public FJPSOpenList
+{
+private:
+	TArray<FJPSHeapEntry> Heap;
+
+public:
+
+	virtual EJPSOpenListType GetType() const override { return EJPSOpenListType::BinaryHeap; }
+
+	virtual void Insert(int32 InValue) override
 	{
-		Heap.Add(InValue);
+		const FJPSNode& Node = (*Arena)[InValue];
+		CellNodes.Add(FIntPoint(Node.Pos.X, Node.Pos.Y), InValue);
+		Heap.Add({ Node.Total, InValue });
+		SetSlot(Heap.Num() - 1);
 		ShiftUp(Heap.Num() - 1);
 	}
 
-	bool InsertSmaller(TSharedPtr<FJPSNode> InValue)
+	virtual bool InsertSmaller(int32 InValue) override
 	{
 		// 같은 위치인데 다른 코스트를 가진 노드라면 갱신시켜준다
-		if (!InValue.IsValid())
+		if (InValue == INDEX_NONE)
 		{
 			return false;
 		}
 
-		int32 HeapSize = Heap.Num();
-
-		for (int32 Node = 0; Node < HeapSize; Node++)
+		const FJPSNode& NewNode = (*Arena)[InValue];
+		int32* OldValue = CellNodes.Find(FIntPoint(NewNode.Pos.X, NewNode.Pos.Y));
+		if (!OldValue)
 		{
-			TSharedPtr<FJPSNode> CurrentNode = Heap[Node];
-			if (!CurrentNode.IsValid())
-			{
-				continue;
-			}
-
-			if (InValue->Pos != CurrentNode->Pos)
-			{
-				continue;
-			}
+			return false;
+		}
 
-			if (InValue->Total >= CurrentNode->Total)
-			{
-				return false;
-			}
-			else
-			{
-				Heap[Node] = InValue;
-				ShiftUp(Node);
-				return true;
-			}
+		// 이미 오픈리스트에서 꺼낸 좌표라면 갱신하지 않는다
+		FJPSNode& OldNode = (*Arena)[*OldValue];
+		if (OldNode.HeapIndex == INDEX_NONE || NewNode.Total >= OldNode.Total)
+		{
+			return false;
 		}
 
-		return false;
+		// 기존 노드 자리에 새 노드를 넣고 줄어든 Total만큼 위로 올린다
+		int32 Slot = OldNode.HeapIndex;
+		OldNode.HeapIndex = INDEX_NONE;
+		*OldValue = InValue;
+		Heap[Slot] = { NewNode.Total, InValue };
+		SetSlot(Slot);
+		ShiftUp(Slot);
+		return true;
 	}
 
-	TSharedPtr<FJPSNode> PopMin()
+	virtual int32 PopMin() override
 	{
 		if (Heap.Num() == 0)
 		{
 			// 힙이 비어 있는 경우 처리 필요
-			return nullptr;
+			return INDEX_NONE;
 		}
 
-		TSharedPtr<FJPSNode> Result = Heap[0];
+		int32 Result = Heap[0].Node;
+		(*Arena)[Result].HeapIndex = INDEX_NONE;
 		Heap[0] = Heap.Last();
 		Heap.Pop();
-		ShiftDown(0);
+		if (Heap.Num() > 0)
+		{
+			SetSlot(0);
+			ShiftDown(0);
+		}
 		return Result;
 	}
 
-	const TSharedPtr<FJPSNode> GetMin() const
+	int32 GetMin() const
 	{
 		if (Heap.Num() > 0)
 		{
-			return Heap[0];
+			return Heap[0].Node;
 		}
 		else
 		{
-			return nullptr;
+			return INDEX_NONE;
 		}
 	}
 
-	int32 GetCount() const { return (int32)Heap.Num(); }
-	void ClearHeap() { Heap.Empty(); }
+	virtual int32 GetCount() const override { return (int32)Heap.Num(); }
+	virtual SIZE_T GetAllocatedSize() const override { return FJPSOpenList::GetAllocatedSize() + Heap.GetAllocatedSize(); }
+	virtual void ClearHeap() override
+	{
+		Heap.Reset();
+		CellNodes.Reset();
+	}
 
 private:
 
+	// 해당 위치에 있는 노드에 힙 안의 위치를 기록
+	void SetSlot(int32 InSlot) { (*Arena)[Heap[InSlot].Node].HeapIndex = InSlot; }
+
+	void SwapSlot(int32 InA, int32 InB)
+	{
+		Heap.Swap(InA, InB);
+		SetSlot(InA);
+		SetSlot(InB);
+	}
+
 	void BuildHeap()
 	{
 		for (int32 i = (Heap.Num() / 2) - 1; i >= 0; --i)
@@ -181,17 +361,17 @@ private:
 			int32 Right = Left + 1;
 			int32 SmallestChild = Left;
 
-			if (Right < HeapSize && Heap[Right]->Total < Heap[Left]->Total)
+			if (Right < HeapSize && Heap[Right].Total < Heap[Left].Total)
 			{
 				SmallestChild = Right;
 			}
 
-			if (Heap[InParent]->Total <= Heap[SmallestChild]->Total)
+			if (Heap[InParent].Total <= Heap[SmallestChild].Total)
 			{
 				break;
 			}
 
-			Heap.Swap(InParent, SmallestChild);
+			SwapSlot(InParent, SmallestChild);
 			InParent = SmallestChild;
 		}
 	}
@@ -202,13 +382,157 @@ private:
 		{
 			int32 Parent = (InNode - 1) / 2;
 
-			if (Heap[InNode]->Total >= Heap[Parent]->Total)
+			if (Heap[InNode].Total >= Heap[Parent].Total)
 			{
 				return;
 			}
 
-			Heap.Swap(InNode, Parent);
+			SwapSlot(InNode, Parent);
 			InNode = Parent;
 		}
 	}
 };
+
+// 라딕스 힙 오픈리스트
+// 옥타일 휴리스틱은 일관성이 있어서 꺼내는 Total이 단조 증가하기 때문에 비교 힙 대신 쓸 수 있다
+// 음수가 아닌 float는 비트값의 대소가 값의 대소와 같으므로 비트값을 키로 사용한다
+class FJPSRadixHeap : public FJPSOpenList
+{
+private:
+	struct FRadixEntry
+	{
+		uint32 Key = 0;
+		int32 Node = INDEX_NONE;
+	};
+
+	// 0번 버킷은 마지막으로 꺼낸 키와 같은 원소, i번 버킷은 마지막 키와 i - 1번 비트부터 달라지는 원소
+	static const int32 NBUCKET = 33;
+	TArray<FRadixEntry> Buckets[NBUCKET];
+	uint32 LastKey = 0;
+	// 갱신되어 버려진 원소를 제외한 원소 수
+	int32 Count = 0;
+
+public:
+
+	virtual EJPSOpenListType GetType() const override { return EJPSOpenListType::RadixHeap; }
+
+	virtual void Insert(int32 InValue) override
+	{
+		const FJPSNode& Node = (*Arena)[InValue];
+		CellNodes.Add(FIntPoint(Node.Pos.X, Node.Pos.Y), InValue);
+		Push(InValue);
+		Count++;
+	}
+
+	virtual bool InsertSmaller(int32 InValue) override
+	{
+		if (InValue == INDEX_NONE)
+		{
+			return false;
+		}
+
+		const FJPSNode& NewNode = (*Arena)[InValue];
+		int32* OldValue = CellNodes.Find(FIntPoint(NewNode.Pos.X, NewNode.Pos.Y));
+		if (!OldValue)
+		{
+			return false;
+		}
+
+		FJPSNode& OldNode = (*Arena)[*OldValue];
+		if (OldNode.HeapIndex == INDEX_NONE || NewNode.Total >= OldNode.Total)
+		{
+			return false;
+		}
+
+		// 기존 원소는 버킷에 남겨두고 꺼낼 때 건너뛴다
+		OldNode.HeapIndex = INDEX_NONE;
+		*OldValue = InValue;
+		Push(InValue);
+		return true;
+	}
+
+	virtual int32 PopMin() override
+	{
+		while (Count > 0)
+		{
+			if (Buckets[0].Num() == 0)
+			{
+				// 비어있지 않은 가장 작은 버킷의 최소 키를 새 기준으로 삼고 아래 버킷으로 재분배한다
+				int32 Bucket = 1;
+				while (Buckets[Bucket].Num() == 0)
+				{
+					Bucket++;
+				}
+
+				uint32 MinKey = MAX_uint32;
+				for (const FRadixEntry& Entry : Buckets[Bucket])
+				{
+					MinKey = FMath::Min(MinKey, Entry.Key);
+				}
+
+				LastKey = MinKey;
+				for (const FRadixEntry& Entry : Buckets[Bucket])
+				{
+					Buckets[GetBucket(Entry.Key)].Add(Entry);
+				}
+				Buckets[Bucket].Reset();
+			}
+
+			FRadixEntry Entry = Buckets[0].Pop();
+			FJPSNode& Node = (*Arena)[Entry.Node];
+			if (Node.HeapIndex == INDEX_NONE)
+			{
+				continue;
+			}
+
+			Node.HeapIndex = INDEX_NONE;
+			Count--;
+			return Entry.Node;
+		}
+		return INDEX_NONE;
+	}
+
+	virtual int32 GetCount() const override { return Count; }
+	virtual SIZE_T GetAllocatedSize() const override
+	{
+		SIZE_T Size = FJPSOpenList::GetAllocatedSize();
+		for (const TArray<FRadixEntry>& Bucket : Buckets)
+		{
+			Size += Bucket.GetAllocatedSize();
+		}
+		return Size;
+	}
+	virtual void ClearHeap() override
+	{
+		for (TArray<FRadixEntry>& Bucket : Buckets)
+		{
+			Bucket.Reset();
+		}
+		CellNodes.Reset();
+		LastKey = 0;
+		Count = 0;
+	}
+
+private:
+
+	static uint32 ToKey(float InTotal)
+	{
+		uint32 Key;
+		FMemory::Memcpy(&Key, &InTotal, sizeof(Key));
+		return Key;
+	}
+
+	int32 GetBucket(uint32 InKey) const
+	{
+		return InKey == LastKey ? 0 : 32 - (int32)FMath::CountLeadingZeros(InKey ^ LastKey);
+	}
+
+	void Push(int32 InValue)
+	{
+		FJPSNode& Node = (*Arena)[InValue];
+		// 오차로 마지막 키보다 작아진 값은 마지막 키로 맞춘다
+		uint32 Key = FMath::Max(ToKey(Node.Total), LastKey);
+		Node.HeapIndex = 0;
+		Buckets[GetBucket(Key)].Add({ Key, InValue });
+	}
+};
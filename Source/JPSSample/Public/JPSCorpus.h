@@ -0,0 +1,42 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "JPSCore.h"
+#include "JPSMovingAI.h"
+
+// 벤치마크 입력 하나, 생성한 맵과 그 맵에서 뽑은 시작/목적지 쌍
+struct FJPSCorpusEntry
+{
+	// 맵 종류, 크기, 시드 같은 생성 조건을 담은 이름, 같은 이름이면 같은 입력이다
+	FString Name;
+	int32 Seed = 0;
+	// 행 우선 비트버퍼 맵, 1이면 충돌지점
+	FJPSMovingAIMap Map;
+	TArray<FPathRequest> Queries;
+};
+
+// 벤치마크 입력 파일
+// 맵을 비트버퍼 그대로 모아서 zlib으로 압축해 저장하기 때문에 다음 실행은 생성 없이 모든 엔진이 같은 입력을 읽는다
+// 생성 규칙이 바뀌면 VERSION을 올려서 이전 파일을 버린다
+class FJPSCorpus
+{
+public:
+	static const int32 VERSION = 1;
+
+	// 파일이 없거나 버전이 다르면 비어있는 상태로 false
+	bool Load(const FString& InPath);
+	bool Save(const FString& InPath);
+
+	const FJPSCorpusEntry* Find(const FString& InName) const;
+	// 같은 이름이 있으면 교체한다
+	const FJPSCorpusEntry& Add(FJPSCorpusEntry&& InEntry);
+	int32 Num() const { return Entries.Num(); }
+	// 읽은 다음 추가된 입력이 있어서 저장해야 하는지
+	bool IsDirty() const { return bDirty; }
+
+private:
+	TArray<FJPSCorpusEntry> Entries;
+	bool bDirty = false;
+};
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "JPSGrid.h"
+
+// 칸 하나와 방향 하나의 경계 상자, Min > Max 이면 비어있다
+struct FJPSBoundBox
+{
+	int16 MinX = MAX_int16;
+	int16 MinY = MAX_int16;
+	int16 MaxX = -1;
+	int16 MaxY = -1;
+
+	bool Contains(int32 InX, int32 InY) const { return InX >= MinX && InX <= MaxX && InY >= MinY && InY <= MaxY; }
+	void Add(int32 InX, int32 InY)
+	{
+		MinX = FMath::Min<int16>(MinX, static_cast<int16>(InX));
+		MinY = FMath::Min<int16>(MinY, static_cast<int16>(InY));
+		MaxX = FMath::Max<int16>(MaxX, static_cast<int16>(InX));
+		MaxY = FMath::Max<int16>(MaxY, static_cast<int16>(InY));
+	}
+};
+
+// 목적지 경계 상자 (Goal Bounding)
+// 칸마다 8방향으로, 그 방향 이동으로 시작하는 최적 경로가 있는 모든 목적지를 감싸는 상자를 저장한다
+// 탐색은 목적지가 상자 밖인 방향을 확장하지 않는다
+// 모든 칸에서 다익스트라를 돌리기 때문에 정적인 작은 맵에서만 쓴다
+class FJPSGoalBounds
+{
+public:
+	// 방향 수 (북(0), 북동(1), 동(2), 남동(3), 남(4), 남서(5), 서(6), 북서(7))
+	static const int32 NDIR = 8;
+	// 전처리 비용이 칸 수의 제곱에 비례하기 때문에 이보다 큰 맵은 만들지 않는다
+	static const int32 MAX_CELLS = 256 * 256;
+
+	// 칸마다 다익스트라를 워커 스레드에 나눠서 실행한다
+	bool Build(const FJPSGridView& InGrid);
+	void Reset();
+
+	bool IsValid() const { return Width > 0 && Height > 0; }
+	SIZE_T GetAllocatedSize() const { return Boxes.GetAllocatedSize(); }
+	double GetBuildSeconds() const { return BuildSeconds; }
+
+	const FJPSBoundBox& Get(int32 InX, int32 InY, int32 InDir) const { return Boxes[(InY * Width + InX) * NDIR + InDir]; }
+	// InX, InY 에서 상자가 목적지를 포함하는 방향들의 비트 집합
+	int32 GetDirections(int32 InX, int32 InY, int32 InGoalX, int32 InGoalY) const;
+
+private:
+	// 워커마다 하나씩 두고 다익스트라 사이에 재사용하는 버퍼
+	struct FScratch;
+	// 한 칸에서 다익스트라로 최적 경로의 첫 이동 방향을 구하고 그 칸의 상자들을 채운다
+	// InOpen은 칸마다 이동 가능하면 1
+	void BuildSource(const TArray<uint8>& InOpen, int32 InSource, FScratch& InScratch);
+
+	TArray<FJPSBoundBox> Boxes;
+	int32 Width = 0;
+	int32 Height = 0;
+	double BuildSeconds = 0.0;
+};
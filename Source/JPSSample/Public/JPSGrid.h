@@ -0,0 +1,289 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+#include "TDBitArray.h"
+#include "JPSBitScan.h"
+#include "JPSCore.h"
+
+// 비트배열 맵의 읽기 전용 뷰
+// 탐색, JPS+ 테이블, 경계 상자는 이 뷰로만 맵을 읽기 때문에 액터나 월드 없이 쓸 수 있다
+// 뷰는 FJPSGrid의 원소를 가리키기만 하므로 FJPSGrid::Create로 맵을 다시 만들면 새로 받아야 한다
+struct FJPSGridView
+{
+	static const int32 NBITMASK = TDBitArray<int64>::NBITMASK;
+
+	// X방향 비트배열, 행 우선이고 1이면 충돌지점
+	const uint64* XWords = nullptr;
+	// Y방향 비트배열, X방향을 전치한 열 우선
+	const uint64* YWords = nullptr;
+	int32 XWordWidths = 0;
+	int32 YWordWidths = 0;
+	int32 Width = 0;
+	int32 Height = 0;
+
+	bool IsValid() const { return XWords != nullptr && Width > 0 && Height > 0; }
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+
+	bool IsOutBound(int32 InX, int32 InY) const
+	{
+		return InX < 0 || InY < 0 || InX >= Width || InY >= Height;
+	}
+
+	// 맵 밖은 충돌지점으로 본다
+	bool IsCollision(int32 InX, int32 InY) const
+	{
+		return IsOutBound(InX, InY) || ((XWords[InY * XWordWidths + InX / NBITMASK] >> (InX % NBITMASK)) & 1);
+	}
+
+	// 한 행(X방향이면 y행, Y방향이면 x열)의 첫 원소
+	const uint64* GetRow(bool InIsXaxis, int32 InRow) const
+	{
+		return InIsXaxis ? XWords + InRow * XWordWidths : YWords + InRow * YWordWidths;
+	}
+	int32 GetWordWidths(bool InIsXaxis) const { return InIsXaxis ? XWordWidths : YWordWidths; }
+
+	// 축과 진행방향별로 특수화된 검색, 충돌지점은 1이므로 원소를 그대로 검색한다
+	template <bool IsXaxis, bool IsForward>
+	int32 GetCloseValue(int32 InX, int32 InY) const { return ScanBoundary<IsXaxis, IsForward>(InX, InY); }
+	// 시작위치부터 진행방향으로 충돌지점 전까지 강제이웃이 생기는 첫 칸의 위치, 없다면 맵 끝(역방향이면 -1)
+	// 현재 행과 양옆 행을 같이 읽어서 한 번에 검색한다, 중간 원소들은 FJPSBitScan의 묶음 검색을 쓴다
+	template <bool IsXaxis, bool IsForward>
+	int32 FindStraightJumpPoint(int32 InX, int32 InY) const;
+	// 한 행에서 InPos부터 진행방향으로 64칸을 원소 하나로 읽는다, 맵 밖의 행과 칸은 충돌지점
+	// IsForward면 i번 비트가 InPos + i, 아니면 63 - i번 비트가 InPos - i
+	template <bool IsXaxis, bool IsForward>
+	uint64 LoadWindow(int32 InRow, int32 InPos) const;
+
+private:
+	// 시작위치부터 진행방향으로 가장 가까운 충돌지점을 찾는다
+	// 축과 방향이 템플릿 인자이기 때문에 안쪽 루프에 분기가 없다
+	template <bool IsXaxis, bool IsForward>
+	int32 ScanBoundary(int32 InX, int32 InY) const;
+
+	// 행의 원소를 읽는다, 맵 밖의 행과 원소, 맵 크기를 넘어선 여분 비트는 충돌지점으로 본다
+	static uint64 LoadBlockedWord(const uint64* InWords, int32 InWord, int32 InLastWord, uint64 InPadMask)
+	{
+		if (!InWords || InWord < 0 || InWord > InLastWord)
+		{
+			return ~0ULL;
+		}
+		return InWord == InLastWord ? (InWords[InWord] | InPadMask) : InWords[InWord];
+	}
+};
+
+// 비트배열 맵
+// 서로 다른 2차원 비트배열을 쓰는 이유는 비트 접근은 가로방향(메모리 연속) 으로만 할 수 있기 때문에 서로 대칭되는 비트배열 2가지를 사용한다
+// UObject에 의존하지 않는다, AJPSCollision은 이 맵을 감싸서 에디터와 블루프린트에 노출한다
+class FJPSGrid
+{
+public:
+	// 비트배열을 새로 만든다, 이전에 받은 뷰는 무효가 된다
+	bool Create(int32 InWidth, int32 InHeight);
+
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	FJPSGridView GetView() const;
+
+	bool IsOutBound(int32 InX, int32 InY) const { return InX < 0 || InY < 0 || InX >= Width || InY >= Height; }
+	bool IsCollision(int32 InX, int32 InY) const { return XBoundaryPoints.IsSet(InX, InY); }
+
+	// 한 칸의 충돌 여부를 바꾼다, 맵 안의 칸이 실제로 바뀌었으면 참
+	bool SetAt(int32 InX, int32 InY, bool InFlag);
+	// 사각형 영역을 한번에 충돌지점으로 설정하거나 해제
+	void FillRect(int32 InX, int32 InY, int32 InWidth, int32 InHeight, bool InFlag);
+	// 행 우선 비트버퍼(한 행에 InWordWidths개의 uint64, 1이면 충돌지점)로 맵 전체를 교체
+	bool ApplyBitmap(TConstArrayView<uint64> InBitmap, int32 InWordWidths);
+	// ApplyBitmap에 넘길 비트버퍼의 한 행 원소 수
+	int32 GetBitmapWordWidths() const { return XBoundaryPoints.GetWordWidths(); }
+
+	const TDBitArray<int64>& GetXBoundaryPoints() const { return XBoundaryPoints; }
+	const TDBitArray<int64>& GetYBoundaryPoints() const { return YBoundaryPoints; }
+
+private:
+	// X방향 비트배열의 영역을 64x64 블록 단위로 전치해서 Y방향 비트배열에 반영
+	void TransposeToYBoundary(int32 InMinX, int32 InMinY, int32 InMaxX, int32 InMaxY);
+
+	// X방향의 2차원 비트배열
+	TDBitArray<int64> XBoundaryPoints;
+	// Y방향의 2차원 비트배열
+	TDBitArray<int64> YBoundaryPoints;
+	int32 Width = 0;
+	int32 Height = 0;
+};
+
+template <bool IsXaxis, bool IsForward>
+int32 FJPSGridView::ScanBoundary(int32 InX, int32 InY) const
+{
+	const int32 MaxValue = IsXaxis ? Width : Height;
+	if (IsOutBound(InX, InY))
+	{
+		return IsForward ? MaxValue : -1;
+	}
+
+	const int32 Variable = IsXaxis ? InX : InY;
+	const int32 Row = IsXaxis ? InY : InX;
+	// 시작위치가 포함된 원소는 항상 읽는다
+	JPS_SEARCH_STAT_ADD(Scans, 1);
+	JPS_SEARCH_STAT_ADD(WordsTouched, 1);
+
+	// 검색할 행의 첫 원소
+	const int32 MaxWidths = IsXaxis ? XWordWidths : YWordWidths;
+	const uint64* Words = GetRow(IsXaxis, Row);
+	int32 Word = Variable / NBITMASK;
+	const int32 Bit = Variable % NBITMASK;
+
+	if constexpr (IsForward)
+	{
+		// 시작위치가 포함된 원소는 시작위치 이전의 비트를 모두 0으로 바꾼다
+		// 1111 -> 1110 -> 1100 -> 1000
+		uint64 Value = Words[Word] & (~0ULL << Bit);
+		if (!Value)
+		{
+			// 나머지 원소는 여러 개씩 묶어서 검사
+			const int32 FirstWord = Word;
+			Word = FJPSBitScan::FindForward(Words, Word + 1, MaxWidths, 0ULL);
+			JPS_SEARCH_STAT_ADD(WordsTouched, FMath::Min(Word, MaxWidths - 1) - FirstWord);
+			if (Word == MaxWidths)
+			{
+				// 없다면 마지막 반환
+				return MaxValue;
+			}
+			Value = Words[Word];
+		}
+		// 맵 크기를 넘어선 여분 비트에서 찾았다면 마지막 반환
+		return FMath::Min(Word * NBITMASK + FJPSBitScan::LowestBit(Value), MaxValue);
+	}
+	else
+	{
+		// 위와 반대로 시작위치 이후의 비트를 모두 0으로 바꾼다
+		// 0001 -> 0011 -> 0111 -> 1111
+		uint64 Value = Words[Word] & (~0ULL >> (NBITMASK - 1 - Bit));
+		if (!Value)
+		{
+			const int32 FirstWord = Word;
+			Word = FJPSBitScan::FindBackward(Words, Word - 1, 0ULL);
+			JPS_SEARCH_STAT_ADD(WordsTouched, FirstWord - FMath::Max(Word, 0));
+			if (Word < 0)
+			{
+				return -1;
+			}
+			Value = Words[Word];
+		}
+		return Word * NBITMASK + FJPSBitScan::HighestBit(Value);
+	}
+}
+
+template <bool IsXaxis, bool IsForward>
+int32 FJPSGridView::FindStraightJumpPoint(int32 InX, int32 InY) const
+{
+	const int32 MaxValue = IsXaxis ? Width : Height;
+	const int32 NotFound = IsForward ? MaxValue : -1;
+	if (IsOutBound(InX, InY))
+	{
+		return NotFound;
+	}
+
+	const int32 Variable = IsXaxis ? InX : InY;
+	const int32 Row = IsXaxis ? InY : InX;
+	const int32 Rows = IsXaxis ? Height : Width;
+
+	// 현재 행과 양옆 행, 맵 밖의 옆 행은 모두 충돌지점
+	const int32 MaxWidths = IsXaxis ? XWordWidths : YWordWidths;
+	const uint64* Self = GetRow(IsXaxis, Row);
+	const uint64* Sides[2] = { Row > 0 ? Self - MaxWidths : nullptr, Row + 1 < Rows ? Self + MaxWidths : nullptr };
+	const int32 LastWord = (MaxValue - 1) / NBITMASK;
+	const uint64 PadMask = ~FJPSBitScan::RangeMask(0, MaxValue - LastWord * NBITMASK);
+
+	// 원소 하나의 64칸에서 멈춰야 하는 칸, 충돌지점과 강제이웃
+	// 옆 행이 막혀있고 진행방향으로 그 다음 칸이 열려있으면 강제이웃이다
+	auto StopBits = [&](int32 InWord) -> uint64
+	{
+		uint64 Stop = LoadBlockedWord(Self, InWord, LastWord, PadMask);
+		for (const uint64* Side : Sides)
+		{
+			const uint64 Current = LoadBlockedWord(Side, InWord, LastWord, PadMask);
+			const uint64 Next = IsForward
+				? (Current >> 1) | (LoadBlockedWord(Side, InWord + 1, LastWord, PadMask) << (NBITMASK - 1))
+				: (Current << 1) | (LoadBlockedWord(Side, InWord - 1, LastWord, PadMask) >> (NBITMASK - 1));
+			Stop |= Current & ~Next;
+		}
+		return Stop;
+	};
+
+	// 첫 원소와 마지막 원소는 여분 비트와 맵 밖을 처리해야 해서 따로 읽고, 그 사이는 세 행을 묶어서 검사하는 공용 커널로 건너뛴다
+	// 맵 밖의 원소는 모두 충돌지점이라 루프는 맵 끝에서 반드시 멈춘다
+	const uint64* SideA = Sides[0] ? Sides[0] : Self;
+	const uint64* SideB = Sides[1] ? Sides[1] : Self;
+	const int32 FirstWord = Variable / NBITMASK;
+	int32 Word = FirstWord;
+	const int32 Bit = Variable % NBITMASK;
+	int32 Pos;
+	if constexpr (IsForward)
+	{
+		uint64 Value = StopBits(Word) & (~0ULL << Bit);
+		if (!Value && Word + 1 < LastWord)
+		{
+			Word = FJPSBitScan::FindStopForward(Self, SideA, SideB, Word + 1, LastWord);
+			Value = StopBits(Word);
+		}
+		while (!Value)
+		{
+			Value = StopBits(++Word);
+		}
+		Pos = Word * NBITMASK + FJPSBitScan::LowestBit(Value);
+	}
+	else
+	{
+		uint64 Value = StopBits(Word) & (~0ULL >> (NBITMASK - 1 - Bit));
+		if (!Value && Word - 1 >= 1)
+		{
+			Word = FJPSBitScan::FindStopBackward(Self, SideA, SideB, Word - 1, 1);
+			Value = StopBits(Word);
+		}
+		while (!Value)
+		{
+			Value = StopBits(--Word);
+		}
+		Pos = Word * NBITMASK + FJPSBitScan::HighestBit(Value);
+	}
+	// 세 행을 같이 읽기 때문에 원소 위치 하나당 세 원소
+	JPS_SEARCH_STAT_ADD(Scans, 1);
+	JPS_SEARCH_STAT_ADD(WordsTouched, 3 * (FMath::Abs(Word - FirstWord) + 1));
+
+	// 충돌지점에서 멈췄다면 점프포인트가 없다
+	if (Pos < 0 || Pos >= MaxValue || (LoadBlockedWord(Self, Pos / NBITMASK, LastWord, PadMask) >> (Pos % NBITMASK)) & 1)
+	{
+		return NotFound;
+	}
+	return Pos;
+}
+
+template <bool IsXaxis, bool IsForward>
+uint64 FJPSGridView::LoadWindow(int32 InRow, int32 InPos) const
+{
+	const int32 Rows = IsXaxis ? Height : Width;
+	if (InRow < 0 || InRow >= Rows)
+	{
+		return ~0ULL;
+	}
+
+	const int32 MaxValue = IsXaxis ? Width : Height;
+	const uint64* Words = GetRow(IsXaxis, InRow);
+	const int32 LastWord = (MaxValue - 1) / NBITMASK;
+	const uint64 PadMask = ~FJPSBitScan::RangeMask(0, MaxValue - LastWord * NBITMASK);
+
+	// 역방향은 InPos가 마지막 비트가 되도록 앞쪽 64칸을 읽는다, 맵 왼쪽 밖의 위치도 내림으로 원소를 구한다
+	const int32 First = IsForward ? InPos : InPos - (NBITMASK - 1);
+	const int32 Word = First >> 6;
+	const int32 Bit = First & (NBITMASK - 1);
+	const uint64 Low = LoadBlockedWord(Words, Word, LastWord, PadMask);
+	if (Bit == 0)
+	{
+		return Low;
+	}
+	return (Low >> Bit) | (LoadBlockedWord(Words, Word + 1, LastWord, PadMask) << (NBITMASK - Bit));
+}
@@ -0,0 +1,54 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "JPSCore.h"
+#include "JPSGrid.h"
+#include "JPSNeighbourMasks.h"
+
+// 격자 A* 탐색 한 번 동안 바뀌는 상태, 스레드마다 하나씩 두고 탐색 사이에 재사용한다
+// 칸 단위 배열은 세대 값으로 유효 여부를 구분하기 때문에 탐색마다 초기화하지 않는다
+struct FJPSGridAStarContext
+{
+	// 힙 안에 없는 칸의 HeapIndices 값
+	static const int32 CLOSED = -2;
+
+	// 맵의 칸 수가 바뀐 경우에만 새로 할당한다
+	void Prepare(int32 InCellCount);
+	// 새 탐색의 세대로 넘어간다, 세대 값이 한 바퀴 돌면 Visited를 지운다
+	void NextGeneration();
+	SIZE_T GetAllocatedSize() const;
+
+	// 칸마다 시작점부터의 비용, 부모 칸, 힙 안의 위치, Visited가 현재 세대인 칸만 유효하다
+	TArray<float> Scores;
+	TArray<int32> Parents;
+	TArray<int32> HeapIndices;
+	TArray<uint32> Visited;
+	uint32 Generation = 0;
+
+	// 열린 칸의 이진 힙, Node는 칸 인덱스
+	TArray<FJPSHeapEntry> Heap;
+
+	// 마지막 탐색의 작업량
+	FJPSSearchStats Stats;
+};
+
+// 격자 전용 A*
+// 범용 그래프용인 FGraphAStar의 노드 풀과 맵 대신 칸 인덱스로 바로 접근하는 배열을 쓴다
+// 비용과 휴리스틱은 JPS와 같은 옥타일 거리라서 같은 맵에서 경로 비용을 그대로 비교할 수 있다
+class FJPSGridAStar
+{
+public:
+	// 맵을 다시 만들면 새 뷰로 다시 호출해야 한다
+	void SetMap(const FJPSGridView& InGrid) { Grid = InGrid; }
+	// 있으면 이동 가능한 이웃만 확장한다, 맵이 바뀌면 마스크도 다시 만들어야 한다
+	void SetNeighbourMasks(const FJPSNeighbourMasks* InMasks) { Masks = InMasks; }
+
+	// 시작점을 포함한 경로의 모든 칸을 순서대로 채운다, 맵을 바꾸지 않는 동안에는 여러 스레드에서 동시에 호출할 수 있다
+	bool Search(FJPSGridAStarContext& InContext, FIntPoint InStartCoord, FIntPoint InEndCoord, TArray<FIntPoint>& OutResultCoord) const;
+
+private:
+	FJPSGridView Grid;
+	const FJPSNeighbourMasks* Masks = nullptr;
+};
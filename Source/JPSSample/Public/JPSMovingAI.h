@@ -0,0 +1,60 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// MovingAI 그리드 벤치마크의 맵 (.map, octile 형식)
+// 행 우선 비트버퍼로 읽기 때문에 AJPSCollision::ApplyBitmap과 AAStarCollision::ApplyBitmap으로 한번에 적용할 수 있다
+struct FJPSMovingAIMap
+{
+	int32 Width = 0;
+	int32 Height = 0;
+	// 한 행의 uint64 원소 수
+	int32 WordWidths = 0;
+	// 1이면 충돌지점
+	TArray<uint64> Bitmap;
+
+	bool IsValid() const { return Width > 0 && Height > 0; }
+	bool IsCollision(int32 InX, int32 InY) const { return (Bitmap[InY * WordWidths + InX / 64] >> (InX % 64)) & 1; }
+};
+
+// MovingAI 시나리오 (.scen) 한 줄
+struct FJPSMovingAIScenario
+{
+	int32 Bucket = 0;
+	// 시나리오 파일에 적힌 맵 파일 이름
+	FString MapName;
+	int32 MapWidth = 0;
+	int32 MapHeight = 0;
+	FIntPoint Start = FIntPoint(-1, -1);
+	FIntPoint Goal = FIntPoint(-1, -1);
+	// 모서리를 끼고 도는 대각선 이동을 허용하지 않는 규칙의 최적 경로 길이
+	double OptimalLength = 0.0;
+};
+
+// 경로 길이를 최적값과 비교한 결과
+// MovingAI는 모서리를 끼고 도는 대각선 이동을 막기 때문에 이를 허용하는 JPS는 최적값보다 짧을 수는 있어도 길면 안 된다
+enum class EJPSScenarioCheck : uint8
+{
+	Optimal,
+	Shorter,
+	Longer,
+	NotFound,
+};
+
+class FJPSMovingAI
+{
+public:
+	// '.', 'G', 'S'는 이동 가능, 나머지('@', 'O', 'T', 'W')는 충돌지점
+	static bool LoadMap(const FString& InPath, FJPSMovingAIMap& OutMap);
+	static bool ParseMap(const FString& InText, FJPSMovingAIMap& OutMap);
+	static bool LoadScenarios(const FString& InPath, TArray<FJPSMovingAIScenario>& OutScenarios);
+	static bool ParseScenarios(const FString& InText, TArray<FJPSMovingAIScenario>& OutScenarios);
+	// 시나리오 파일 옆에서 시나리오가 가리키는 맵 파일을 찾는다
+	static FString ResolveMapPath(const FString& InScenarioPath, const FJPSMovingAIScenario& InScenario);
+
+	// 꺾이는 점만 있는 경로와 칸마다 있는 경로를 같은 옥타일 거리로 잰다
+	static double GetPathLength(FIntPoint InStart, TConstArrayView<FIntPoint> InPath);
+	static EJPSScenarioCheck CheckPath(const FJPSMovingAIScenario& InScenario, bool InFound, double InLength);
+};
@@ -0,0 +1,49 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "JPSGrid.h"
+
+// 칸마다 이동 가능한 이웃을 8비트로 저장한 표
+// 비트 i가 1이면 i방향(북(0), 북동(1), 동(2), 남동(3), 남(4), 남서(5), 서(6), 북서(7)) 이웃이 맵 안의 이동 가능한 칸이다
+// 범용 그래프 탐색이 방향마다 범위와 충돌을 검사하지 않고 유효한 이웃만 나열할 때 쓴다
+class FJPSNeighbourMasks
+{
+public:
+	static const int32 NDIR = 8;
+
+	// 맵의 비트배열로부터 64칸씩 한번에 만든다, 맵이 바뀌면 다시 만들어야 한다
+	bool Build(const FJPSGridView& InGrid);
+	// InRect(Max는 포함하지 않는다) 영역이 바뀐 뒤 그 영역과 한 칸 둘레만 다시 계산한다
+	bool Update(const FJPSGridView& InGrid, const FIntRect& InRect);
+	void Reset();
+
+	bool IsValid() const { return Width > 0 && Height > 0; }
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	SIZE_T GetAllocatedSize() const { return Masks.GetAllocatedSize(); }
+
+	uint8 Get(int32 InX, int32 InY) const { return Masks[InY * Width + InX]; }
+
+	// 마스크에서 InIndex번째로 켜진 비트의 방향
+	static int32 GetNthDirection(uint8 InMask, int32 InIndex)
+	{
+		uint32 Mask = InMask;
+		for (int32 Index = 0; Index < InIndex; Index++)
+		{
+			Mask &= Mask - 1;
+		}
+		return static_cast<int32>(FMath::CountTrailingZeros(Mask));
+	}
+	static FIntPoint GetOffset(int32 InDir)
+	{
+		static const FIntPoint Offsets[NDIR] = { FIntPoint(0, -1), FIntPoint(1, -1), FIntPoint(1, 0), FIntPoint(1, 1), FIntPoint(0, 1), FIntPoint(-1, 1), FIntPoint(-1, 0), FIntPoint(-1, -1) };
+		return Offsets[InDir];
+	}
+
+private:
+	TArray<uint8> Masks;
+	int32 Width = 0;
+	int32 Height = 0;
+};
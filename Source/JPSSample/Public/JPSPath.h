@@ -4,10 +4,11 @@
 
 #include "CoreMinimal.h"
 #include "JPSCore.h"
-#include "TDBitArray.h"
 #include "JPSCollision.h"
+#include "JPSPathfinder.h"
 
 #include "JPSPath.generated.h"
+
 /**
  * 
  */
@@ -20,69 +21,56 @@ public:
 
 	void SetMap(AJPSCollision* InFieldCollision);
 	void DestroyMap();
+	void SetOpenListType(EJPSOpenListType InType) { Pathfinder.SetOpenListType(InType); }
+	// JPS+ 점프 거리 테이블, 테이블이 있으면 Jump 대신 테이블로 점프포인트를 구한다
+	bool BuildJumpTable() { return Pathfinder.BuildJumpTable(); }
+	void ResetJumpTable() { Pathfinder.ResetJumpTable(); }
+	bool HasJumpTable() const { return Pathfinder.HasJumpTable(); }
+	// 한 칸이 바뀐 뒤 테이블의 영향받는 부분만 고친다, 실패하면 테이블을 버린다
+	bool RepairJumpTable(int32 InX, int32 InY) { return Pathfinder.RepairJumpTable(InX, InY); }
+	// 목적지 경계 상자, 있으면 목적지가 상자 밖인 방향은 확장하지 않는다
+	// 맵이 바뀌면 고칠 수 없기 때문에 버린다
+	bool BuildGoalBounds() { return Pathfinder.BuildGoalBounds(); }
+	void ResetGoalBounds() { Pathfinder.ResetGoalBounds(); }
+	bool HasGoalBounds() const { return Pathfinder.HasGoalBounds(); }
+	const FJPSGoalBounds& GetGoalBounds() const { return Pathfinder.GetGoalBounds(); }
 	bool Search(FIntPoint InStartCoord, FIntPoint InEndCoord, TArray<FIntPoint>& OutResultCoord);
-
-private:
-
-	inline bool IsPassable(const JPSCoord& InCoord)
+	// 게임 스레드의 Search가 마지막으로 남긴 작업량
+	const FJPSSearchStats& GetLastSearchStats() const { return Pathfinder.GetLastSearchStats(); }
+	// 주어진 컨텍스트로 탐색, 맵을 바꾸지 않는 동안에는 여러 스레드에서 동시에 호출할 수 있다
+	bool Search(FJPSSearchContext& InContext, FIntPoint InStartCoord, FIntPoint InEndCoord, TArray<FIntPoint>& OutResultCoord) const
 	{
-		if (FieldCollision.IsValid())
-		{
-			return !FieldCollision->IsOutBound(InCoord.X, InCoord.Y) && !FieldCollision->IsCollision(InCoord.X, InCoord.Y);
-		}
-		return false;
+		return Pathfinder.Search(InContext, InStartCoord, InEndCoord, OutResultCoord);
 	}
-
-	inline int32 DirIsDiagonal(const int32 InDir)
+	// 탐색을 여러 프레임에 나눠서 실행한다, BeginSearch로 시작하고 InProgress가 아닐 때까지 StepSearch를 호출한다
+	bool BeginSearch(FJPSSearchContext& InContext, FIntPoint InStartCoord, FIntPoint InEndCoord) const
 	{
-		// 대각선인지 판단
-		return (InDir % 2) != 0;
+		return Pathfinder.BeginSearch(InContext, InStartCoord, InEndCoord);
 	}
-
-	inline int32 Implies(const int32 InA, const int32 InB)
+	EJPSSearchStatus StepSearch(FJPSSearchContext& InContext, const FJPSSearchBudget& InBudget, TArray<FIntPoint>& OutResultCoord, bool InPartialPath = false) const
 	{
-		// a와 b의 값이 둘 다 존재하거나 둘 다 존재하지 않으면 참
-		return InA ? InB : 1;
+		return Pathfinder.StepSearch(InContext, InBudget, OutResultCoord, InPartialPath);
 	}
+	// 요청들을 워커 스레드에 나눠서 탐색하고 끝날 때까지 기다린다, OutResults는 요청 수 이상이어야 한다
+	void FindPathBatch(TConstArrayView<FPathRequest> InRequests, TArrayView<FPathResult> OutResults);
+
+	// 비동기 탐색에 쓸 컨텍스트를 빌리고 돌려준다, 게임 스레드에서만 호출한다
+	FJPSSearchContext* AcquireContext() { return Pathfinder.AcquireContext(); }
+	void ReleaseContext(FJPSSearchContext* InContext) { Pathfinder.ReleaseContext(InContext); }
 
-	inline int32 AddDirectionToSet(const int32 InDirs, const int32 InDir)
+	bool PullingString(TArray<JPSCoord>& InResultNodes) const { return Pathfinder.PullingString(InResultNodes); }
+	bool IsStraightPassable(int32 InFromX, int32 InFromY, int32 InToX, int32 InToY) const
 	{
-		// 방향 추가
-		return InDirs | 1 << InDir;
+		return Pathfinder.IsStraightPassable(InFromX, InFromY, InToX, InToY);
 	}
 
-	FIntPoint GetNorthEndPointReOpenBB(int32 InX, int32 InY);
-	FIntPoint GetSouthEndPointReOpenBB(int32 InX, int32 InY);
-	FIntPoint GetEastEndPointReOpenBB(int32 InX, int32 InY);
-	FIntPoint GetWestEndPointReOpenBB(int32 InX, int32 InY);
-
-	JPSCoord NextCoordinate(const JPSCoord& InCoord, const int32 InDir);
-	int32 GetCoordinateDir(const JPSCoord& InSCoord, const JPSCoord& InDirCoord);
-	int32 GetForcedNeighbours(const JPSCoord& InCoord, const int32 InDir);
-	int32 GetNaturalNeighbours(const int32 InDir);
-
-	bool GetJumpPoint(JPSCoord InSCoord, const char direction, JPSCoord& OutJumpPoint);
-	JPSCoord Jump(const JPSCoord& InCoord, const char InDir);
-
-public:
-	bool PullingString(TArray<JPSCoord>& InResultNodes);
-	bool IsStraightPassable(int32 InFromX, int32 InFromY, int32 InToX, int32 InToY);
+	// 워커 스레드는 UObject 대신 이 탐색 객체를 직접 들고 탐색한다
+	const FJPSPathfinder& GetPathfinder() const { return Pathfinder; }
 
 private:
-	// 방향
-	// 북(0), 북동(1), 동(2), 남동(3), 남(4), 남서(5), 서(6), 북서(7) , 시작점(8방)
-	const int32	NODIRECTION = 8;
-
-	// 열 노드
-	UPROPERTY()
-	UJPSHeap* OpenList;
-
-	// 닫힌 노드
-	TDBitArray<int64> ClosedList;
-
-	JPSCoord EndPos;
+	FJPSPathfinder Pathfinder;
 
+	// 맵 액터가 살아있는지만 확인한다, 탐색은 SetMap에서 받은 뷰로 맵을 읽는다
+	// 이 객체는 맵 액터의 서브오브젝트이므로 맵보다 오래 살지 않는다
 	TWeakObjectPtr<AJPSCollision> FieldCollision;
-	int32 GridWidth = 0;
-	int32 GridHeight = 0;
 };
@@ -0,0 +1,85 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+// 경로 캐시 카운터
+struct FJPSPathCacheStats
+{
+	int32 Hits = 0;
+	int32 Misses = 0;
+	// 용량이 차서 가장 오래 쓰지 않은 경로를 버린 횟수
+	int32 Evictions = 0;
+	// 맵이 바뀌어서 버린 경로 수
+	int32 Invalidations = 0;
+
+	void Reset() { *this = FJPSPathCacheStats(); }
+};
+
+// 시작/목적지 쌍으로 찾은 경로를 저장하는 LRU 캐시
+// 경로는 양방향으로 같은 비용이기 때문에 A->B 경로를 뒤집어서 B->A 요청에도 쓴다
+// 저장할 때의 맵 버전과 다른 버전으로 찾으면 버린다, 맵을 바꾼 쪽은 Invalidate로 영향을 받는 경로만 버리고 나머지를 새 버전으로 옮긴다
+class FJPSPathCache
+{
+public:
+	// 0이면 캐시하지 않는다, 줄이면 오래된 경로부터 버린다
+	void SetCapacity(int32 InCapacity);
+	int32 GetCapacity() const { return Capacity; }
+	int32 Num() const { return Lookup.Num(); }
+
+	// 있으면 InStart부터 InEnd까지의 점 목록으로 채운다
+	bool Find(FIntPoint InStart, FIntPoint InEnd, uint32 InVersion, TArray<FIntPoint>& OutPath);
+	// 찾은 경로만 저장한다, InPath는 InStart부터 InEnd까지 직선이나 대각선으로 이어지는 점 목록
+	void Add(FIntPoint InStart, FIntPoint InEnd, uint32 InVersion, TConstArrayView<FIntPoint> InPath);
+
+	// InRect(Max는 포함하지 않는다) 영역이 바뀐 뒤 호출한다
+	// 막힌 경우 그 영역을 지나는 경로만, 열린 경우 그 영역을 거쳐서 더 짧아질 수 있는 경로만 버린다
+	void Invalidate(const FIntRect& InRect, bool InBlocked, uint32 InNewVersion);
+	void Reset();
+
+	const FJPSPathCacheStats& GetStats() const { return Stats; }
+	void ResetStats() { Stats.Reset(); }
+
+private:
+	// 두 점을 정렬한 키라서 A->B와 B->A가 같은 원소를 찾는다
+	struct FKey
+	{
+		FIntPoint A;
+		FIntPoint B;
+
+		bool operator==(const FKey& InRhs) const { return A == InRhs.A && B == InRhs.B; }
+		friend uint32 GetTypeHash(const FKey& InKey) { return HashCombine(GetTypeHash(InKey.A), GetTypeHash(InKey.B)); }
+	};
+
+	struct FEntry
+	{
+		FKey Key;
+		// Key.A부터 Key.B까지의 점 목록
+		TArray<FIntPoint> Path;
+		float Cost = 0.0f;
+		// 경로가 지나는 칸을 모두 포함하는 영역, Max는 포함하지 않는다
+		FIntRect Bounds;
+		uint32 Version = 0;
+		// 사용 순서 목록, Prev 쪽이 최근에 쓴 원소
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+	};
+
+	static FKey MakeKey(FIntPoint InStart, FIntPoint InEnd, bool& OutReversed);
+	// 경로의 칸 중 하나라도 InRect 안에 있는지
+	static bool Crosses(const FEntry& InEntry, const FIntRect& InRect);
+
+	void Link(int32 InIndex);
+	void Unlink(int32 InIndex);
+	void Remove(int32 InIndex);
+
+	TArray<FEntry> Entries;
+	TArray<int32> FreeEntries;
+	TMap<FKey, int32> Lookup;
+	int32 Head = INDEX_NONE;
+	int32 Tail = INDEX_NONE;
+	int32 Capacity = 0;
+
+	FJPSPathCacheStats Stats;
+};
@@ -0,0 +1,155 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "JPSCore.h"
+#include "TDBitArray.h"
+#include "JPSGrid.h"
+#include "JPSPlusTable.h"
+#include "JPSGoalBounds.h"
+
+// 탐색 한 번 동안 바뀌는 상태
+// 맵은 탐색 중 읽기만 하기 때문에 스레드마다 컨텍스트를 하나씩 두면 같은 맵을 동시에 탐색할 수 있다
+struct FJPSSearchContext
+{
+	// 맵 크기와 오픈리스트 구현이 바뀐 경우에만 새로 할당한다
+	void Prepare(int32 InWidth, int32 InHeight, EJPSOpenListType InType);
+	// 탐색 사이에 유지하는 버퍼들의 용량
+	SIZE_T GetAllocatedSize() const;
+
+	// 열 노드
+	TUniquePtr<FJPSOpenList> OpenList;
+
+	// 닫힌 노드, 탐색마다 이전 탐색에서 사용한 원소만 초기화한다
+	TDTrackedBitArray<int64> ClosedList;
+
+	// 탐색중 생성된 노드, 탐색마다 용량을 유지한 채 초기화한다
+	FJPSNodeArena Nodes;
+
+	// 역추적한 점프포인트 목록
+	TArray<JPSCoord> PathResults;
+
+	JPSCoord EndPos;
+
+	// 나눠서 탐색할 때 단계 사이에 유지하는 상태
+	EJPSSearchStatus Status = EJPSSearchStatus::Failed;
+	// 지금까지 생성한 노드 중 목적지까지의 추정비용이 가장 작은 노드, 부분 경로의 끝점
+	int32 BestNode = INDEX_NONE;
+	// BeginSearch 이후의 작업량, 탐색이 끝나면 STATGROUP_JPS와 CSV 프로파일러에도 더한다
+	FJPSSearchStats Stats;
+};
+
+// JPS 탐색
+// 맵은 FJPSGridView로만 읽고 UObject에 의존하지 않기 때문에 월드 없이 만들어서 쓸 수 있다
+// UJPSPath는 이 객체를 감싸서 맵 액터에 붙인다
+class FJPSPathfinder
+{
+public:
+	// 맵을 다시 만들면 새 뷰로 다시 호출해야 한다
+	void SetMap(const FJPSGridView& InGrid);
+	void DestroyMap();
+	void SetOpenListType(EJPSOpenListType InType);
+	// JPS+ 점프 거리 테이블, 테이블이 있으면 Jump 대신 테이블로 점프포인트를 구한다
+	bool BuildJumpTable();
+	void ResetJumpTable() { JumpTable.Reset(); }
+	bool HasJumpTable() const { return JumpTable.IsValid(); }
+	const FJPSPlusTable& GetJumpTable() const { return JumpTable; }
+	// 한 칸이 바뀐 뒤 테이블의 영향받는 부분만 고친다, 실패하면 테이블을 버린다
+	bool RepairJumpTable(int32 InX, int32 InY);
+	// 목적지 경계 상자, 있으면 목적지가 상자 밖인 방향은 확장하지 않는다
+	// 맵이 바뀌면 고칠 수 없기 때문에 버린다
+	bool BuildGoalBounds();
+	void ResetGoalBounds() { GoalBounds.Reset(); }
+	bool HasGoalBounds() const { return GoalBounds.IsValid(); }
+	const FJPSGoalBounds& GetGoalBounds() const { return GoalBounds; }
+	bool Search(FIntPoint InStartCoord, FIntPoint InEndCoord, TArray<FIntPoint>& OutResultCoord);
+	// 게임 스레드의 Search가 마지막으로 남긴 작업량
+	const FJPSSearchStats& GetLastSearchStats() const { return GameThreadContext.Stats; }
+	// 주어진 컨텍스트로 탐색, 맵을 바꾸지 않는 동안에는 여러 스레드에서 동시에 호출할 수 있다
+	bool Search(FJPSSearchContext& InContext, FIntPoint InStartCoord, FIntPoint InEndCoord, TArray<FIntPoint>& OutResultCoord) const;
+	// 탐색을 여러 프레임에 나눠서 실행한다, BeginSearch로 시작하고 InProgress가 아닐 때까지 StepSearch를 호출한다
+	// 단계 사이에 맵이 바뀌면 결과를 보장하지 않으므로 다시 시작해야 한다
+	bool BeginSearch(FJPSSearchContext& InContext, FIntPoint InStartCoord, FIntPoint InEndCoord) const;
+	// 예산을 다 쓰면 InProgress를 돌려주고, InPartialPath면 추정비용이 가장 작은 노드까지의 경로를 채운다
+	EJPSSearchStatus StepSearch(FJPSSearchContext& InContext, const FJPSSearchBudget& InBudget, TArray<FIntPoint>& OutResultCoord, bool InPartialPath = false) const;
+	// 요청들을 워커 스레드에 나눠서 탐색하고 끝날 때까지 기다린다, OutResults는 요청 수 이상이어야 한다
+	void FindPathBatch(TConstArrayView<FPathRequest> InRequests, TArrayView<FPathResult> OutResults);
+
+	// 비동기 탐색에 쓸 컨텍스트를 빌리고 돌려준다, 게임 스레드에서만 호출한다
+	FJPSSearchContext* AcquireContext();
+	void ReleaseContext(FJPSSearchContext* InContext);
+
+private:
+
+	inline bool IsPassable(const JPSCoord& InCoord) const
+	{
+		return !Grid.IsCollision(InCoord.X, InCoord.Y);
+	}
+
+	inline int32 DirIsDiagonal(const int32 InDir) const
+	{
+		// 대각선인지 판단
+		return (InDir % 2) != 0;
+	}
+
+	inline int32 Implies(const int32 InA, const int32 InB) const
+	{
+		// a와 b의 값이 둘 다 존재하거나 둘 다 존재하지 않으면 참
+		return InA ? InB : 1;
+	}
+
+	inline int32 AddDirectionToSet(const int32 InDirs, const int32 InDir) const
+	{
+		// 방향 추가
+		return InDirs | 1 << InDir;
+	}
+
+	JPSCoord NextCoordinate(const JPSCoord& InCoord, const int32 InDir) const;
+	int32 GetCoordinateDir(const JPSCoord& InSCoord, const JPSCoord& InDirCoord) const;
+	int32 GetForcedNeighbours(const JPSCoord& InCoord, const int32 InDir) const;
+	int32 GetNaturalNeighbours(const int32 InDir) const;
+
+	// 노드부터 부모를 따라가며 방향이 바뀌는 점프포인트를 모은다, InReachedEnd면 목적지를 마지막 점으로 붙인다
+	void TracePath(FJPSSearchContext& InContext, int32 InNode, bool InReachedEnd, TArray<FIntPoint>& OutResultCoord) const;
+
+	// InCoord 다음 칸부터 직선 방향으로 벽 앞까지 원소 단위로 검사해서 첫 점프포인트(목적지 포함)를 구한다, 없다면 빈 좌표
+	JPSCoord StraightJumpPoint(const JPSCoord& InCoord, const int32 InDir, const JPSCoord& InEndPos) const;
+	JPSCoord Jump(const JPSCoord& InCoord, const char InDir, const JPSCoord& InEndPos) const;
+	// 대각선 점프, 지나는 행과 열을 64칸 창으로 읽어서 칸마다 강제이웃과 양옆 직선 검사를 창 안의 비트 연산으로 끝낸다
+	// 한 창은 세 칸 동안 밀어가며 다시 쓰기 때문에 한 칸 진행할 때 행과 열 창을 하나씩만 읽는다
+	template <int32 InDirX, int32 InDirY>
+	JPSCoord JumpDiagonal(const JPSCoord& InCoord, const JPSCoord& InEndPos) const;
+	JPSCoord JumpWithTable(const JPSCoord& InCoord, const char InDir, const JPSCoord& InEndPos) const;
+
+public:
+	bool PullingString(TArray<JPSCoord>& InResultNodes) const;
+	bool IsStraightPassable(int32 InFromX, int32 InFromY, int32 InToX, int32 InToY) const;
+
+private:
+	// 방향
+	// 북(0), 북동(1), 동(2), 남동(3), 남(4), 남서(5), 서(6), 북서(7) , 시작점(8방)
+	const int32	NODIRECTION = 8;
+
+	EJPSOpenListType OpenListType = EJPSOpenListType::BinaryHeap;
+
+	// 게임 스레드의 Search에서 쓰는 컨텍스트
+	FJPSSearchContext GameThreadContext;
+
+	// 일괄 탐색에서 워커마다 하나씩 쓰는 컨텍스트, 호출 사이에 재사용한다
+	TArray<TUniquePtr<FJPSSearchContext>> BatchContexts;
+
+	// 비동기 탐색용 컨텍스트, 모두 이 배열이 소유하고 빌려준 동안에는 FreeAsyncContexts에서 빠진다
+	TArray<TUniquePtr<FJPSSearchContext>> AsyncContexts;
+	TArray<FJPSSearchContext*> FreeAsyncContexts;
+
+	// 정적 맵에서 쓰는 JPS+ 테이블
+	FJPSPlusTable JumpTable;
+	// 정적 맵에서 쓰는 목적지 경계 상자
+	FJPSGoalBounds GoalBounds;
+
+	// 탐색 중 읽기 전용으로 접근하는 맵
+	FJPSGridView Grid;
+	int32 GridWidth = 0;
+	int32 GridHeight = 0;
+};
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "JPSGrid.h"
+
+// JPS+ 점프 거리 테이블
+// 이동 가능한 칸마다 8방향으로 다음 점프포인트까지의 거리(양수) 또는 벽 앞까지의 거리(0 이하)를 저장한다
+// 탐색은 Jump의 비트 검색 대신 테이블 값을 읽어서 점프포인트를 바로 구한다
+// 수리는 제자리에서 하므로 맵과 마찬가지로 탐색이 실행중이지 않을 때만 해야 한다
+class FJPSPlusTable
+{
+public:
+	// 방향 수 (북(0), 북동(1), 동(2), 남동(3), 남(4), 남서(5), 서(6), 북서(7))
+	static const int32 NDIR = 8;
+
+	// 맵의 비트배열로부터 테이블을 만든다, 맵이 int16 범위를 넘으면 실패
+	bool Build(const FJPSGridView& InGrid);
+	void Reset();
+	// 한 칸의 충돌 여부가 바뀐 뒤 영향을 받는 행, 열, 대각선만 다시 계산한다
+	// 주변 3행과 3열의 직선 거리를 다시 구하고, 거리가 바뀐 칸을 지나는 대각선만 바뀌지 않는 칸이 나올 때까지 거슬러 올라간다
+	bool Repair(const FJPSGridView& InGrid, int32 InX, int32 InY);
+
+	bool IsValid() const { return Width > 0 && Height > 0; }
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	SIZE_T GetAllocatedSize() const { return Distances.GetAllocatedSize(); }
+
+	int32 Get(int32 InX, int32 InY, int32 InDir) const { return Distances[(InY * Width + InX) * NDIR + InDir]; }
+
+private:
+	void Set(int32 InX, int32 InY, int32 InDir, int32 InDistance) { Distances[(InY * Width + InX) * NDIR + InDir] = static_cast<int16>(InDistance); }
+
+	// 한 행(X방향이면 y행, Y방향이면 x열)의 직선 두 방향 거리를 계산
+	void BuildStraightRow(const FJPSGridView& InGrid, bool InIsXaxis, int32 InRow);
+	// InDir 방향 대각선 한 줄의 거리를 계산, InStartX/Y는 진행방향으로 줄의 마지막 칸
+	void BuildDiagonalLine(const FJPSGridView& InGrid, int32 InDir, int32 InStartX, int32 InStartY);
+	// 다음 칸의 거리(InNextDistance)로 InX, InY 칸의 대각선 거리를 계산
+	int32 ComputeDiagonal(const FJPSGridView& InGrid, int32 InX, int32 InY, int32 InDir, int32 InNextDistance) const;
+
+	TArray<int16> Distances;
+	int32 Width = 0;
+	int32 Height = 0;
+};
@@ -10,6 +10,9 @@
 class AMaze;
 class AJPSCollision;
 class AAStarCollision;
+struct FJPSMovingAIMap;
+struct FPathRequest;
+struct FJPSMapChange;
 
 UENUM(BlueprintType)
 enum class EMapType : uint8
@@ -55,13 +58,46 @@ public:
 	UFUNCTION(BlueprintCallable, CallInEditor, Category = "PathFinding")
 	void PathFindingSimulate();
 
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "PathFinding")
+	void OpenListBenchmark();
+
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "PathFinding")
+	void BitScanBenchmark();
+
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "PathFinding")
+	void BatchBenchmark();
+
+	// MovingAI 시나리오 파일의 모든 문제를 JPS와 GraphAStar로 풀고 경로 길이를 최적값과 비교한다
+	UFUNCTION(BlueprintCallable, CallInEditor, Category = "PathFinding")
+	void RunMovingAIScenarios();
+
 	FVector GetNodeLocation(int32 InX, int32 InY, bool InCheckNavmesh = true);
 	FIntPoint LocationToCoord(FVector InLocation);
 
+	// 현재 크기로 JPS 맵을 새로 만들고 AStar는 그 비트배열을 공유한다, JPS 액터가 없으면 AStar가 직접 만든다
+	void CreateCollisionMaps();
+	// JPS 맵이 바뀌면 공유중인 AStar 맵의 뷰와 이웃 마스크를 맞춘다
+	void OnJPSMapChanged(const FJPSMapChange& InChange);
+	// 행 우선 비트버퍼(1이면 충돌지점)를 JPS와 AStar 맵에 적용
+	void ApplyBitmap(const TArray<uint64>& InBitmap, int32 InWordWidths);
+	// GridMap[y][x] == 1 인 칸을 충돌지점으로 적용, GridMap 밖의 칸은 InBlockOutside에 따른다
+	void ApplyGridMap(const TArray<TArray<uint8>>& InGridMap, bool InBlockOutside);
+	// MovingAI 맵이나 벤치마크 입력 파일의 맵 크기로 JPS와 AStar 맵을 다시 만들고 비트버퍼를 한번에 적용
+	void ApplyMovingAIMap(const FJPSMovingAIMap& InMap);
+	// MapType의 맵을 시드로 생성해서 비트버퍼로 돌려주고 시작/목적지를 정한다, 같은 시드면 같은 맵이다
+	// 내비메시를 따르는 맵은 월드에서 읽어야 하므로 생성하지 않는다
+	bool GenerateMap(int32 InSeed, FJPSMovingAIMap& OutMap);
+	// JPS+ 테이블, 목적지 경계 상자, AStar 이웃 마스크처럼 맵을 다 채운 다음 만드는 데이터
+	void BuildPrecomputedData();
+	// 생성기가 정한 시작/목적지와 이동 가능한 칸끼리 시드로 뽑은 요청, 모두 InCount개
+	TArray<FPathRequest> MakeSimulateQueries(const FJPSMovingAIMap& InMap, int32 InCount, int32 InSeed) const;
+	// GridMap[y][x] == 1 인 칸을 현재 맵 크기의 비트버퍼로 변환, GridMap 밖의 칸은 InBlockOutside에 따른다
+	void GridMapToBitmap(const TArray<TArray<uint8>>& InGridMap, bool InBlockOutside, FJPSMovingAIMap& OutMap) const;
+
 	bool OverlapsMyBox(const FMyBox& InBoxA, const FMyBox& InBoxB);
-	TArray<TArray<uint8>> GenerateMaze(int32 InMapSize);
-	TArray<TArray<uint8>> GenerateRoomsMap(int32 InMapSize);
-	TArray<TArray<uint8>> GenerateBlock(int32 InMapSize);
+	TArray<TArray<uint8>> GenerateMaze(int32 InMapSize, int32 InSeed);
+	TArray<TArray<uint8>> GenerateRoomsMap(int32 InMapSize, int32 InSeed);
+	TArray<TArray<uint8>> GenerateBlock(int32 InMapSize, int32 InSeed);
 
 protected:
 	// Called when the game starts or when spawned
@@ -99,9 +135,49 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
 	EMapType MapType;
 
+	// 맵 생성 시드, PathFindingSimulate는 반복마다 1씩 더한 시드를 쓴다
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	int32 MapSeed;
+
+	// 벤치마크 입력 파일 경로, 지정하면 PathFindingSimulate가 생성한 맵과 시작/목적지를 저장해두고 다음 실행에서 생성 없이 읽는다
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	FString CorpusPath;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
 	int32 PathFindingSimulateCount;
 
+	// PathFindingSimulate에서 맵 하나당 측정할 탐색 수
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	int32 PathFindingQueryCount;
+
+	// 맵마다 측정 전에 버리는 탐색 수
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	int32 PathFindingWarmupCount;
+
+	// 평균을 낼 때 양 끝에서 각각 버리는 표본 비율
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder", meta = (ClampMin = "0.0", ClampMax = "0.5"))
+	float PathFindingTrimRatio;
+
+	// 오픈리스트 벤치마크에서 맵 하나당 반복할 탐색 횟수
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	int32 OpenListBenchmarkCount;
+
+	// 비트 검색 벤치마크의 반복 횟수
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	int32 BitScanBenchmarkCount;
+
+	// 일괄 탐색 벤치마크의 요청 수
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	int32 BatchBenchmarkCount;
+
+	// MovingAI 시나리오 파일(.scen) 경로
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	FString MovingAIScenarioPath;
+
+	// MovingAI 맵 파일(.map) 경로, 비어있으면 시나리오 파일 옆에서 찾는다
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	FString MovingAIMapPath;
+
 public:
 
 	UPROPERTY(EditAnywhere)
@@ -130,4 +206,6 @@ private:
 	int32 JPSCount;
 	double AStarTime;
 	double JPSTime;
+
+	FDelegateHandle MapChangedHandle;
 };
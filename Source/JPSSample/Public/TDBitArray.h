@@ -22,7 +22,7 @@ public:
 	static const Ty	CLEARBITS = 0;
 public:
 	// 그리드의 길이를 Ty의 크기로 나눈다
-	FDivResult Divide(int32 InPos)
+	FDivResult Divide(int32 InPos) const
 	{
 		FDivResult Result;
 		Result.Quotient = InPos / NBITMASK;
@@ -30,9 +30,9 @@ public:
 		return Result;
 	}
 	// 나머지를 받아서 원소의 비트 위치로 시프트하여 비트마스크를 생성한다
-	Ty DivMaskbits(const FDivResult& InDiv) { return (Ty)1 << InDiv.Remainder; }
+	Ty DivMaskbits(const FDivResult& InDiv) const { return (Ty)1 << InDiv.Remainder; }
 	// 2차원 좌표를 1차원 pos로 전환한다
-	int32 ToOneDimensionPos(int32 InX, int32 InY) { return (int32)(InY * Bitswidths + InX); }
+	int32 ToOneDimensionPos(int32 InX, int32 InY) const { return (int32)(InY * Bitswidths + InX); }
 
 public:
 	int32 GetBitsWidths() const { return Bitswidths; }
@@ -118,7 +118,7 @@ public:
 		return true;
 	}
 
-	bool IsSet(int32 InX, int32 InY)
+	bool IsSet(int32 InX, int32 InY) const
 	{
 		// 2차원 좌표를 받아서 해당 위치의 비트가 1인지 0인지 확인
 		int32 Pos = ToOneDimensionPos(InX, InY);
@@ -141,4 +141,56 @@ public:
 	int32 Width = 0;
 	// 그리드의 열
 	int32 Depth = 0;
+};
+
+// 0에서 값이 바뀐 원소의 위치를 기록해두었다가 그 원소들만 다시 0으로 되돌리는 비트배열
+// 맵 전체를 지우지 않기 때문에 초기화 비용이 이전에 사용한 범위에 비례한다
+template <typename Ty>
+class TDTrackedBitArray : public TDBitArray<Ty>
+{
+public:
+	void Create(int32 InWidth, int32 InDepth)
+	{
+		TDBitArray<Ty>::Create(InWidth, InDepth);
+		Clear();
+	}
+
+	void Clear()
+	{
+		TDBitArray<Ty>::Clear();
+		TouchedWords.Reset();
+	}
+
+	// 기록된 원소만 0으로 되돌린다
+	void ClearTouched()
+	{
+		for (int32 Word : TouchedWords)
+		{
+			(*this)[Word] = TDBitArray<Ty>::CLEARBITS;
+		}
+		TouchedWords.Reset();
+	}
+
+	bool SetAt(int32 InX, int32 InY, bool InFlag)
+	{
+		int32 Pos = this->ToOneDimensionPos(InX, InY);
+		if (Pos < 0 || Pos >= (static_cast<int32>(this->Num()) * TDBitArray<Ty>::NBITMASK))
+		{
+			return false;
+		}
+
+		// 처음 값이 생기는 원소라면 기록
+		FDivResult Div = this->Divide(Pos);
+		if (InFlag && (*this)[Div.Quotient] == TDBitArray<Ty>::CLEARBITS)
+		{
+			TouchedWords.Add(Div.Quotient);
+		}
+		return TDBitArray<Ty>::SetAt(InX, InY, InFlag);
+	}
+
+	int32 GetTouchedCount() const { return TouchedWords.Num(); }
+
+private:
+	// 0에서 값이 바뀐 원소의 인덱스
+	TArray<int32> TouchedWords;
 };
\ No newline at end of file